@@ -351,6 +351,15 @@ BOOST_PYTHON_MODULE(riversim)
         .def("quality", &tethex::MeshElement::quality, args("points"))
     ;
 
+    class_<tethex::FlatMesh>("FlatMesh", "Quadrangular mesh stored in flat arrays.")
+        .def_readwrite("vertices", &tethex::FlatMesh::vertices, "Coordinates of vertices: x0, y0, x1, y1, ...")
+        .def("getNVertices", &tethex::FlatMesh::get_n_vertices)
+        .def("getNQuadrangles", &tethex::FlatMesh::get_n_quadrangles)
+        .def("getNLines", &tethex::FlatMesh::get_n_lines)
+        .def("write", static_cast< void (tethex::FlatMesh::*)(const string&) const>(&tethex::FlatMesh::write), args("file"), "Write mesh in Gmsh 2.2 format.")
+        .def("clear", &tethex::FlatMesh::clear)
+    ;
+
     class_<tethex::Mesh>("TethexMesh")
         .def(init<>())
         .def(init<const tethex::Mesh&>(args("mesh")))
@@ -420,9 +429,14 @@ BOOST_PYTHON_MODULE(riversim)
         .def_readwrite("min_edge", &MeshParams::min_edge, "Minimal edge size.")
         .def_readwrite("smoothness_degree", &MeshParams::smoothness_degree, "Smoothnes minimal degree. This value sets threshold for degree between adjacent points below which it should be ignored. This creates smaller mesh.")
         .def_readwrite("ignored_smoothness_length", &MeshParams::ignored_smoothness_length, "Smoothnes minimal length. This value sets threshold for length where smoothnest near tip will be ignored. Ideally it should be bigger then integration radius.")
+        .def_readwrite("remeshing_radius", &MeshParams::remeshing_radius, "If positive, then at each step only region closer then this radius to tips or changed boundary is triangulated again.")
+        .def_readwrite("full_remeshing_period", &MeshParams::full_remeshing_period, "Number of incremental remeshing steps after which whole region is triangulated again. Zero value means no limit.")
         .def_readwrite("ratio", &MeshParams::ratio, "Ratio of the triangles.")
         .def("meshAreaConstraint", &MeshParams::meshAreaConstraint, args("x", "y"), "Evaluates mesh area constraint at {x, y} point.")
         .def("refinementFunction", &MeshParams::refinementFunction, args("p1", "p2", "p3", "area"), "Specifies a function to indicate whether mesh cells should be refined or not.")
+        .def("buildTipsIndex", &MeshParams::BuildTipsIndex, "Builds uniform grid index over tip points, should be called after tip points are changed.")
+        .def("clearTipsIndex", &MeshParams::ClearTipsIndex, "Removes index of tip points.")
+        .def("influenceRadius", &MeshParams::InfluenceRadius, "Distance beyond which tip doesn't change mesh area constraint.")
         .def("__str__", &River::print<MeshParams>)
         .def("__repr__", &River::print<MeshParams>)
     ;
@@ -431,7 +445,13 @@ BOOST_PYTHON_MODULE(riversim)
     //TRIANGLE.hpp
     class_<Triangle>("Triangle", init<>())
         .def(init<MeshParams>(args("mesh_params")))
+        .def_readwrite("timers", &Triangle::timers, "Time of triangulation and conversion.")
         .def("generate", &Triangle::generate_quadrangular_mesh, args("boundary", "holes"), "Generate mesh.")
+        .def("generateFlat", &Triangle::generate_flat_quadrangular_mesh, args("boundary", "holes"), "Generate mesh in flat arrays, without tethex mesh elements.")
+        .def("updateFlat", &Triangle::update_flat_quadrangular_mesh, args("boundary", "holes"), 
+            "Update previously generated flat mesh only around tips and changed lines, if MeshParams.remeshing_radius is positive.")
+        .def("clearTriangulation", &Triangle::clear_triangulation, "Forget triangulation stored by updateFlat, so next update is full.")
+        .def("lastUpdateIsIncremental", &Triangle::last_update_is_incremental, "True if last call of updateFlat remeshed only cavities.")
         .def("printOptions", &Triangle::print_options, args("qDetailedDescription"), "Outupts options with or without detailed description.")
         .def_readwrite("refine", &Triangle::Refine, "Refine previously generated mesh, with preserving of segments")
         .def_readwrite("constrain_angle", &Triangle::ConstrainAngle, "Sets minimum angle value.")
@@ -464,6 +484,13 @@ BOOST_PYTHON_MODULE(riversim)
         .def_readwrite("static_refinment_steps", &SolverParams::static_refinment_steps, "Number of mesh refinment steps used by Deal.II mesh functionality.")
         .def_readwrite("refinment_fraction", &SolverParams::refinment_fraction, "Fraction of refined mesh elements.")
         .def_readwrite("quadrature_degree", &SolverParams::quadrature_degree, "Polynom degree of quadrature integration.")
+        .def_readwrite("preconditioner_type", &SolverParams::preconditioner_type, "Preconditioner of CG solver(0 - SSOR, 1 - Jacobi, 2 - algebraic multigrid, 3 - geometric multigrid).")
+        .def_readwrite("warm_start", &SolverParams::warm_start, "If true, CG starts from previous growth step solution.")
+        .def_readwrite("num_of_threads", &SolverParams::num_of_threads, "Number of threads used by system assembly(0 - all available cores).")
+        .def_readwrite("matrix_free", &SolverParams::matrix_free, "If true, Laplace operator is applied matrix free.")
+        .def_readwrite("condensation_radius", &SolverParams::condensation_radius, "Radius around tips of zone which is solved at each step, far field is condensed into Schur complement, 0 - whole region is solved.")
+        .def_readwrite("mixed_precision", &SolverParams::mixed_precision, "If true, CG runs in single precision with double precision residual correction.")
+        .def_readwrite("direct_solver", &SolverParams::direct_solver, "If true, system is solved by UMFPACK with reused factorization.")
         .def_readwrite("renumbering_type", &SolverParams::renumbering_type, "Renumbering algorithm(0 - none, 1 - cuthill McKee, 2 - hierarchical, 3 - random, ...) for the degrees of freedom on a triangulation.")
         .def_readwrite("max_distance", &SolverParams::max_distance, "Maximal distance between middle point and first solved point, used in non euler growth.")
         .def_readwrite("field_value", &SolverParams::field_value, "Field value used for Poisson conditions.")
@@ -478,6 +505,9 @@ BOOST_PYTHON_MODULE(riversim)
         .def_readwrite("exponant", &IntegrationParams::exponant, "Controls slope.")
         .def_readwrite("eps", &IntegrationParams::eps, "Series params integral precision.")
         .def_readwrite("n_rho", &IntegrationParams::n_rho, "Rho integration step.")
+        .def_readwrite("integration_method", &IntegrationParams::integration_method, "0 - uniform polar grid, 1 - Gauss-Legendre in rho and trapezoidal in phi.")
+        .def_readwrite("spectral_eps", &IntegrationParams::spectral_eps, "Target relative accuracy of nested Fejer grids integration.")
+        .def_readwrite("spectral_max_levels", &IntegrationParams::spectral_max_levels, "Maximal number of doublings of nested Fejer grid, no more then 6.")
         .def("weightFunction", &IntegrationParams::WeightFunction, "Weight function used in computation of series parameters.")
         .def("baseVectorFinal", &IntegrationParams::BaseVectorFinal, "Base Vector function used in computation of series parameters.")
         .def("__str__", &River::print<IntegrationParams>)
@@ -489,19 +519,32 @@ BOOST_PYTHON_MODULE(riversim)
         .def_readwrite("number_of_iterations", &River::Solver::number_of_iterations, "Number of solver iterations.")
         .def_readwrite("num_of_adaptive_refinments", &River::Solver::num_of_adaptive_refinments, "Number of adaptive mesh refinments. Splits mesh elements and resolves.")
         .def_readwrite("num_of_static_refinments", &River::Solver::num_of_static_refinments, "Number of static mesh refinments. Splits elements without resolving.")
+        .def_readwrite("preconditioner_type", &River::Solver::preconditioner_type, "Preconditioner of CG solver(0 - SSOR, 1 - Jacobi, 2 - algebraic multigrid, 3 - geometric multigrid).")
+        .def_readwrite("number_of_solver_iterations", &River::Solver::number_of_solver_iterations, "Number of CG iterations done by last run.")
+        .def_readonly("is_system_reused", &River::Solver::is_system_reused, "True if degrees of freedom and stiffness matrix are kept from previous run.")
+        .def_readwrite("warm_start", &River::Solver::warm_start, "If true, CG starts from previous growth step solution.")
+        .def_readwrite("matrix_free", &River::Solver::matrix_free, "If true, Laplace operator is applied matrix free.")
+        .def_readwrite("condensation_radius", &River::Solver::condensation_radius, "Radius around tips of zone which is solved at each step, 0 - off.")
+        .def_readwrite("mixed_precision", &River::Solver::mixed_precision, "If true, CG runs in single precision with double precision residual correction.")
+        .def_readwrite("direct_solver", &River::Solver::direct_solver, "If true, system is solved by UMFPACK with reused factorization.")
         .def_readwrite("field_value", &River::Solver::field_value, "Outer field value. See Puasson, Laplace equations.")
         .def_readwrite("refinment_fraction", &River::Solver::refinment_fraction, "Refinment fraction. Used static mesh elements refinment.")
         .def_readwrite("coarsening_fraction", &River::Solver::coarsening_fraction, "Coarsening fraction. Used static mesh elements refinment.")
+        .def_readwrite("timers", &River::Solver::timers, "Time of solver phases.")
         .def("openMesh", static_cast< void (River::Solver::*)(const tethex::Mesh&)>( &River::Solver::OpenMesh), args("mesh"), "Open mesh data from tethex::mesh object.")
+        .def("openFlatMesh", static_cast< void (River::Solver::*)(const tethex::FlatMesh&)>( &River::Solver::OpenMesh), args("mesh"), "Open mesh data from tethex::FlatMesh object.")
         .def("openMeshFromFile", static_cast< void (River::Solver::*)(const string fileName)>( &River::Solver::OpenMesh), args("file_name"), "Open mesh data from file. Msh 2 format.")
+        .def("openMeshIfChanged", &River::Solver::OpenMeshIfChanged, args("mesh", "num_of_static_refinments", "integration_radius", "tips_points"), 
+            "Open and statically refine mesh, unless it is the same as previous one. Returns true if triangulation is reused.")
         .def("staticRefineGrid", &River::Solver::static_refine_grid, "Static adaptive mesh refinment.")
         .def("setBoundaryConditions", &River::Solver::setBoundaryConditions, args("boundary_conditions"), "Set boundary conditions.")
         .def("numberOfDOFs", &River::Solver::NumberOfDOFs, "Number of degree of freedom.")
         .def("numberOfCells", &River::Solver::NumberOfRefinedCells, "Number of refined by Deal.II mesh cells.")
         .def("run", &River::Solver::run, "Run fem solution.")
-        .def("outputResults", &River::Solver::output_results, args("file_name"), "Save results to VTK file.")
+        .def("outputResults", static_cast< void (River::Solver::*)(const string) const>(&River::Solver::output_results), args("file_name"), "Save results to VTK file.")
         .def("integrate", &River::Solver::integrate, args("integ", "point", "angle"), "Interation of series parameters around tips points.")
         .def("integrate_new", &River::Solver::integrate_new, args("integ", "point", "angle"), "Interation of series parameters around tips points.")
+        .def("integrate_spectral", static_cast< vector<double> (River::Solver::*)(const IntegrationParams&, const River::Point&, const double)>( &River::Solver::integrate_spectral ), args("integ", "point", "angle"), "Interation of series parameters around tips points using nested Fejer grids.")
         .def("integrate_trap", &River::Solver::integrate_trap, args("integ", "point", "angle"), "Interation of series parameters around tips points using thrapezoidla method.")
         .def("integral_value_res", &River::Solver::integral_value_res, args("rho", "phi", "tip_coord", "angle", "integ"), "Function used in series parameters evaluation")
         .def("solved", &River::Solver::solved)
@@ -509,6 +552,7 @@ BOOST_PYTHON_MODULE(riversim)
         .def("setupSystem", &River::Solver::setup_system, "setup_system.")
         .def("assembleSystem", &River::Solver::assemble_system, "assemble_system.")
         .def("solve", &River::Solver::solve, "solve.")
+        .def("savePreviousSolution", &River::Solver::save_previous_solution, "Keeps copy of current mesh and solution for warm start.")
         .def("value", &River::Solver::value, args("p"), "Returns value of solution at specific coord p.")
         .def("valueSafe", &River::Solver::valueSafe, args("x", "y"), "Returns value of solution at specific coord {x, y} and handles exceptions.")
         .def("refineGrid", &River::Solver::refine_grid, "refine_grid.")
@@ -626,10 +670,13 @@ BOOST_PYTHON_MODULE(riversim)
         .def(self == self)
         .def_readwrite("save_vtk", &ProgramOptions::save_vtk, "Outputs VTK file of Deal.II solution.")
         .def_readwrite("save_each_step", &ProgramOptions::save_each_step)
+        .def_readwrite("mesh_output_format", &ProgramOptions::mesh_output_format, "Format of mesh file saved at each step: 0 - none, 1 - text MSH 2.2, 2 - binary MSH 2.2, 3 - binary MSH 4.1.")
         .def_readwrite("verbose", &ProgramOptions::verbose, "If true - then program will print to standard output.")
         .def_readwrite("debug", &ProgramOptions::debug, "If true - then program will save additional output files for each stage of simulation.")
         .def_readwrite("output_file_name", &ProgramOptions::output_file_name)
         .def_readwrite("input_file_name", &ProgramOptions::input_file_name)
+        .def_readwrite("output_queue_size", &ProgramOptions::output_queue_size, "Maximal number of output files queued for writing in background, 0 - files are written synchronously.")
+        .def_readwrite("journal_snapshot_period", &ProgramOptions::journal_snapshot_period, "Period in steps of full snapshots of journal, 0 - journal isn't written and whole state is saved at each step.")
         .def("__str__", &River::print<ProgramOptions>)
         .def("__repr__", &River::print<ProgramOptions>)
     ;
@@ -642,6 +689,14 @@ BOOST_PYTHON_MODULE(riversim)
         .def(map_indexing_suite<t_ids_series_params>())
     ;
     
+    //TIMERS.hpp
+    class_<Timers>("Timers", "Wall time and counters of simulation phases.")
+        .def("nextStep", &Timers::next_step, "Resets values of current step, totals are kept.")
+        .def("clear", &Timers::clear, "Removes all phases and counters.")
+        .def("__str__", &River::print<Timers>)
+        .def("__repr__", &River::print<Timers>)
+    ;
+
     class_<River::RiverSolver, boost::noncopyable>("RiverSolver", "Algorithms of river evolution.", init<const River::Model, const River::ProgramOptions>(args("model", "prog_opt")))
     //    .def(init<const Model, const ProgramOptions>(args("model", "prog_opt")))
         .def("run", &RiverSolver::run)
@@ -661,6 +716,8 @@ BOOST_PYTHON_MODULE(riversim)
         .def_readwrite("triangle", &RiverSolver::triangle)
         .def_readwrite("mesh", &RiverSolver::mesh)
         .def_readwrite("solver", &RiverSolver::solver)
+        .def_readwrite("timers", &RiverSolver::timers)
+        .def("recordStepTimers", &RiverSolver::record_step_timers, "Appends time of phases of current step to simulation data.")
     ;
 
 }
\ No newline at end of file
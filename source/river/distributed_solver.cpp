@@ -0,0 +1,428 @@
+/*
+ * riversim - river growth simulation.
+ * Copyright (c) 2019 Oleg Kmechak
+ * Report issues: github.com/okmechak/RiverSim/issues
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ */
+
+#include "distributed_solver.hpp"
+
+#ifdef RIVERSIM_DISTRIBUTED_SOLVER
+
+///\cond
+#include <numeric>
+///\endcond
+
+namespace River
+{
+    DistributedSolver::DistributedSolver(const SolverParams &solver_params, const MPI_Comm mpi_communicator, const bool verbose):
+        tollerance{solver_params.tollerance},
+        number_of_iterations{solver_params.num_of_iterrations},
+        preconditioner_type{solver_params.preconditioner_type},
+        field_value{solver_params.field_value},
+        mpi_communicator{mpi_communicator},
+        triangulation{mpi_communicator},
+        cache{triangulation},
+        dof_handler{triangulation},
+        fe{solver_params.quadrature_degree},
+        quadrature_formula{solver_params.quadrature_degree},
+        face_quadrature_formula{solver_params.quadrature_degree},
+        verbose{verbose}
+    {}
+
+    void DistributedSolver::clear()
+    {
+        dof_handler.clear();
+        triangulation.clear();
+        constraints.clear();
+        system_matrix.clear();
+        locally_owned_boxes.clear();
+        number_of_solver_iterations = 0;
+    }
+
+    void DistributedSolver::OpenMesh(const tethex::FlatMesh &mesh)
+    {
+        auto timer = timers.scope("OpenMesh/CreateTriangulation");
+        std::vector<dealii::Point<dim>> vertices(mesh.get_n_vertices());
+        for(size_t i = 0; i < vertices.size(); ++i)
+            vertices[i] = dealii::Point<dim>(mesh.vertices[2 * i], mesh.vertices[2 * i + 1]);
+
+        std::vector<CellData<dim>> cells(mesh.get_n_quadrangles());
+        for(size_t i = 0; i < cells.size(); ++i)
+        {
+            for(unsigned k = 0; k < GeometryInfo<dim>::vertices_per_cell; ++k)
+                cells[i].vertices[k] = mesh.quadrangles[4 * i + k];
+            cells[i].material_id = mesh.quadrangle_material_ids[i];
+            cells[i].manifold_id = static_cast<types::manifold_id>(101);
+        }
+
+        SubCellData subcelldata;
+        subcelldata.boundary_lines.resize(mesh.get_n_lines());
+        for(size_t i = 0; i < subcelldata.boundary_lines.size(); ++i)
+        {
+            subcelldata.boundary_lines[i].vertices[0] = mesh.lines[2 * i];
+            subcelldata.boundary_lines[i].vertices[1] = mesh.lines[2 * i + 1];
+            subcelldata.boundary_lines[i].material_id = mesh.line_material_ids[i];
+        }
+
+        triangulation.create_triangulation(vertices, cells, subcelldata);
+    }
+
+    void DistributedSolver::static_refine_grid(unsigned int num_of_static_refinments, const double integration_radius, const t_PointList &tips_points)
+    {
+        auto timer = timers.scope("OpenMesh/StaticRefinement");
+        for (unsigned step = 0; step < num_of_static_refinments; ++step)
+        {
+            // flags of other cells are set by their owners, p4est keeps 2:1 balance between processes
+            for (const auto &cell : triangulation.active_cell_iterators())
+            {
+                if (!cell->is_locally_owned())
+                    continue;
+
+                for (unsigned int v = 0; v < GeometryInfo<dim>::vertices_per_cell && !cell->refine_flag_set(); ++v)
+                    for (const auto &p : tips_points)
+                        if (dealii::Point<dim>{p.x, p.y}.distance(cell->vertex(v)) < integration_radius)
+                        {
+                            cell->set_refine_flag();
+                            break;
+                        }
+            }
+            triangulation.execute_coarsening_and_refinement();
+        }
+    }
+
+    void DistributedSolver::setBoundaryConditions(const BoundaryConditions &boundary_conds)
+    {
+        boundary_conditions = boundary_conds;
+    }
+
+    void DistributedSolver::setup_system()
+    {
+        auto timer = timers.scope("Solve/Setup");
+        dof_handler.distribute_dofs(fe);
+
+        locally_owned_dofs = dof_handler.locally_owned_dofs();
+        DoFTools::extract_locally_relevant_dofs(dof_handler, locally_relevant_dofs);
+
+        locally_relevant_solution.reinit(locally_owned_dofs, locally_relevant_dofs, mpi_communicator);
+        system_rhs.reinit(locally_owned_dofs, mpi_communicator);
+
+        // Dirichlet values are eliminated during assembly together with hanging nodes
+        constraints.clear();
+        constraints.reinit(locally_relevant_dofs);
+        DoFTools::make_hanging_node_constraints(dof_handler, constraints);
+        for (const auto &[boundary_id, boundary_condition] : boundary_conditions.Get(DIRICHLET))
+            VectorTools::interpolate_boundary_values(
+                dof_handler,
+                boundary_id,
+                Functions::ConstantFunction<dim>(boundary_condition.value),
+                constraints);
+        constraints.close();
+
+        DynamicSparsityPattern dsp(locally_relevant_dofs);
+        DoFTools::make_sparsity_pattern(dof_handler, dsp, constraints, false);
+        SparsityTools::distribute_sparsity_pattern(
+            dsp,
+            dof_handler.n_locally_owned_dofs_per_processor(),
+            mpi_communicator,
+            locally_relevant_dofs);
+
+        system_matrix.reinit(locally_owned_dofs, locally_owned_dofs, dsp, mpi_communicator);
+
+        locally_owned_boxes = GridTools::compute_mesh_predicate_bounding_box(
+            triangulation, IteratorFilters::LocallyOwnedCell(), 1, true, 8);
+    }
+
+    void DistributedSolver::assemble_system()
+    {
+        auto timer = timers.scope("Solve/Assembly");
+        const auto neuman_bd = boundary_conditions.Get(NEUMAN);
+
+        FEValues<dim> fe_values(fe, quadrature_formula,
+            update_values | update_gradients | update_quadrature_points | update_JxW_values);
+        FEFaceValues<dim> fe_face_values(fe, face_quadrature_formula,
+            update_values | update_quadrature_points | update_JxW_values);
+
+        const unsigned dofs_per_cell = fe.dofs_per_cell;
+        const unsigned n_q_points = quadrature_formula.size();
+        const unsigned n_face_q_points = face_quadrature_formula.size();
+
+        FullMatrix<double> cell_matrix(dofs_per_cell, dofs_per_cell);
+        Vector<double> cell_rhs(dofs_per_cell);
+        vector<types::global_dof_index> local_dof_indices(dofs_per_cell);
+
+        for (const auto &cell : dof_handler.active_cell_iterators())
+        {
+            if (!cell->is_locally_owned())
+                continue;
+
+            cell_matrix = 0;
+            cell_rhs = 0;
+            fe_values.reinit(cell);
+
+            for (unsigned q_index = 0; q_index < n_q_points; ++q_index)
+                for (unsigned i = 0; i < dofs_per_cell; ++i)
+                {
+                    for (unsigned j = 0; j < dofs_per_cell; ++j)
+                        cell_matrix(i, j) += fe_values.shape_grad(i, q_index) *
+                                             fe_values.shape_grad(j, q_index) *
+                                             fe_values.JxW(q_index);
+
+                    cell_rhs(i) += field_value *
+                                   fe_values.shape_value(i, q_index) *
+                                   fe_values.JxW(q_index);
+                }
+
+            for (unsigned face_number = 0; face_number < GeometryInfo<dim>::faces_per_cell; ++face_number)
+                if (cell->face(face_number)->at_boundary() &&
+                    neuman_bd.count(cell->face(face_number)->boundary_id()))
+                {
+                    fe_face_values.reinit(cell, face_number);
+                    const auto neuman_value = neuman_bd.at(cell->face(face_number)->boundary_id()).value;
+                    for (unsigned q_point = 0; q_point < n_face_q_points; ++q_point)
+                        for (unsigned i = 0; i < dofs_per_cell; ++i)
+                            cell_rhs(i) += neuman_value *
+                                           fe_face_values.shape_value(i, q_point) *
+                                           fe_face_values.JxW(q_point);
+                }
+
+            cell->get_dof_indices(local_dof_indices);
+            constraints.distribute_local_to_global(cell_matrix, cell_rhs, local_dof_indices, system_matrix, system_rhs);
+        }
+
+        system_matrix.compress(VectorOperation::add);
+        system_rhs.compress(VectorOperation::add);
+    }
+
+    void DistributedSolver::solve()
+    {
+        auto timer = timers.scope("Solve/CG");
+        TrilinosWrappers::MPI::Vector completely_distributed_solution(locally_owned_dofs, mpi_communicator);
+
+        SolverControl solver_control(number_of_iterations, tollerance);
+        SolverCG<TrilinosWrappers::MPI::Vector> cg(solver_control);
+
+        if (preconditioner_type == 0)
+        {
+            // SSOR is applied to diagonal block of each process
+            TrilinosWrappers::PreconditionSSOR preconditioner;
+            preconditioner.initialize(system_matrix, TrilinosWrappers::PreconditionSSOR::AdditionalData(1.2));
+            cg.solve(system_matrix, completely_distributed_solution, system_rhs, preconditioner);
+        }
+        else if (preconditioner_type == 1)
+        {
+            TrilinosWrappers::PreconditionJacobi preconditioner;
+            preconditioner.initialize(system_matrix);
+            cg.solve(system_matrix, completely_distributed_solution, system_rhs, preconditioner);
+        }
+        else if (preconditioner_type == 2)
+        {
+            TrilinosWrappers::PreconditionAMG::AdditionalData amg_data;
+            amg_data.elliptic = true;
+            amg_data.higher_order_elements = fe.degree > 1;
+            amg_data.smoother_sweeps = 2;
+            amg_data.aggregation_threshold = 0.02;
+
+            TrilinosWrappers::PreconditionAMG preconditioner;
+            preconditioner.initialize(system_matrix, amg_data);
+            cg.solve(system_matrix, completely_distributed_solution, system_rhs, preconditioner);
+        }
+        else
+            throw Exception("DistributedSolver::solve: unsupported preconditioner type: " + to_string(preconditioner_type));
+
+        number_of_solver_iterations += solver_control.last_step();
+
+        constraints.distribute(completely_distributed_solution);
+        locally_relevant_solution = completely_distributed_solution;
+    }
+
+    void DistributedSolver::run()
+    {
+        number_of_solver_iterations = 0;
+        setup_system();
+        if (verbose)
+            cout << "\t distributed degrees of freedom: " << dof_handler.n_dofs()
+                << ", cells: " << triangulation.n_global_active_cells() << endl;
+        assemble_system();
+        solve();
+        if (verbose)
+            cout << "\t solver iterations: " << number_of_solver_iterations << endl;
+    }
+
+    void DistributedSolver::output_results(const string file_name) const
+    {
+        DataOut<dim> data_out;
+        data_out.attach_dof_handler(dof_handler);
+        data_out.add_data_vector(locally_relevant_solution, "solution");
+
+        Vector<float> subdomain(triangulation.n_active_cells());
+        for (unsigned i = 0; i < subdomain.size(); ++i)
+            subdomain(i) = triangulation.locally_owned_subdomain();
+        data_out.add_data_vector(subdomain, "subdomain");
+        data_out.build_patches();
+
+        const auto rank = Utilities::MPI::this_mpi_process(mpi_communicator);
+        const auto piece_name = [&file_name](const unsigned rank)
+        {
+            return file_name + "_" + Utilities::int_to_string(rank, 4) + ".vtu";
+        };
+
+        ofstream output(piece_name(rank));
+        output.precision(20); // Fix for paraview
+        data_out.write_vtu(output);
+
+        if (rank == 0)
+        {
+            // pieces are referenced relative to record
+            const auto directory_length = file_name.find_last_of('/') + 1;
+            vector<string> piece_names;
+            for (unsigned i = 0; i < Utilities::MPI::n_mpi_processes(mpi_communicator); ++i)
+                piece_names.push_back(piece_name(i).substr(directory_length));
+
+            ofstream record(file_name + ".pvtu");
+            data_out.write_pvtu_record(record, piece_names);
+        }
+    }
+
+    void DistributedSolver::local_values(const t_PointList &points, vector<double> &point_values, vector<double> &mask) const
+    {
+        point_values.assign(points.size(), 0);
+        mask.assign(points.size(), 0);
+
+        Vector<double> cell_values(fe.dofs_per_cell);
+        auto cell_hint = typename Triangulation<dim>::active_cell_iterator();
+        for (size_t k = 0; k < points.size(); ++k)
+        {
+            const dealii::Point<dim> p{points[k].x, points[k].y};
+            if (none_of(locally_owned_boxes.begin(), locally_owned_boxes.end(),
+                [&p](const BoundingBox<dim> &box){ return box.point_inside(p); }))
+                continue;
+
+            try
+            {
+                const auto [tria_cell, unit_point] = GridTools::find_active_cell_around_point(cache, p, cell_hint);
+                // ghost and artificial cells are evaluated by their owners
+                if (!tria_cell->is_locally_owned())
+                    continue;
+                cell_hint = tria_cell;
+
+                const typename DoFHandler<dim>::active_cell_iterator cell(&triangulation, tria_cell->level(), tria_cell->index(), &dof_handler);
+                cell->get_dof_values(locally_relevant_solution, cell_values);
+
+                double value = 0;
+                for (unsigned i = 0; i < fe.dofs_per_cell; ++i)
+                    value += cell_values(i) * fe.shape_value(i, unit_point);
+
+                point_values[k] = value;
+                mask[k] = 1;
+            }
+            catch (const GridTools::ExcPointNotFound<dim> &error)
+            {
+                // point is outside of region
+            }
+        }
+    }
+
+    void DistributedSolver::reduce_values(vector<double> &point_values, vector<double> &mask) const
+    {
+        point_values = Utilities::MPI::sum(point_values, mpi_communicator);
+        mask = Utilities::MPI::sum(mask, mpi_communicator);
+
+        // point on common edge of cells of different processes is evaluated by each of them
+        for (size_t k = 0; k < mask.size(); ++k)
+            if (mask[k] > 1)
+            {
+                point_values[k] /= mask[k];
+                mask[k] = 1;
+            }
+    }
+
+    void DistributedSolver::values(const t_PointList &points, vector<double> &point_values, vector<double> &mask) const
+    {
+        local_values(points, point_values, mask);
+        reduce_values(point_values, mask);
+    }
+
+    void DistributedSolver::integrate_stencil(const IntegrationStencil &stencil, const t_PointList &tips_points, const vector<double> &tips_angles,
+        const vector<size_t> &tips, vector<vector<double>> &tips_values, vector<vector<double>> &tips_mask, vector<vector<double>> &series_params)
+    {
+        // only samples, which aren't evaluated yet, are appended to values of tips
+        vector<size_t> offsets;
+        t_PointList sample_points;
+        for (const auto i: tips)
+        {
+            offsets.push_back(sample_points.size());
+            const auto tip_samples = stencil.Points(tips_points[i], tips_angles[i], tips_values[i].size());
+            sample_points.insert(sample_points.end(), tip_samples.begin(), tip_samples.end());
+        }
+        offsets.push_back(sample_points.size());
+
+        vector<double> sample_values, mask;
+        {
+            auto timer = timers.scope("Integration/Evaluation");
+            local_values(sample_points, sample_values, mask);
+        }
+
+        {
+            auto timer = timers.scope("Integration/Reduction");
+            reduce_values(sample_values, mask);
+        }
+
+        for (size_t t = 0; t < tips.size(); ++t)
+        {
+            auto &values = tips_values[tips[t]], &values_mask = tips_mask[tips[t]];
+            values.insert(values.end(), sample_values.begin() + offsets[t], sample_values.begin() + offsets[t + 1]);
+            values_mask.insert(values_mask.end(), mask.begin() + offsets[t], mask.begin() + offsets[t + 1]);
+            series_params[tips[t]] = stencil.SeriesParameters(values, values_mask);
+        }
+    }
+
+    vector<vector<double>> DistributedSolver::integrate_tips(const IntegrationParams &integ, const t_PointList &tips_points, const vector<double> &tips_angles)
+    {
+        vector<vector<double>> series_params(tips_points.size()), tips_values(tips_points.size()), tips_mask(tips_points.size());
+        vector<size_t> tips(tips_points.size());
+        iota(tips.begin(), tips.end(), 0);
+
+        if (integ.integration_method != 1)
+        {
+            integrate_stencil(IntegrationStencil(integ), tips_points, tips_angles, tips, tips_values, tips_mask, series_params);
+            return series_params;
+        }
+
+        integrate_stencil(IntegrationStencil(integ, 0), tips_points, tips_angles, tips, tips_values, tips_mask, series_params);
+        const auto max_levels = min(integ.spectral_max_levels, IntegrationParams::spectral_levels_limit);
+        for (unsigned level = 1; level <= max_levels && !tips.empty(); ++level)
+        {
+            const auto prev_series_params = series_params;
+            integrate_stencil(IntegrationStencil(integ, level), tips_points, tips_angles, tips, tips_values, tips_mask, series_params);
+
+            // all processes get same values, so they drop same tips
+            vector<size_t> unconverged_tips;
+            for (const auto i: tips)
+            {
+                double max_diff = 0, max_value = EPS;
+                for (unsigned j = 0; j < series_params[i].size(); ++j)
+                {
+                    max_diff = max(max_diff, abs(series_params[i][j] - prev_series_params[i][j]));
+                    max_value = max(max_value, abs(series_params[i][j]));
+                }
+
+                if (!(max_diff / max_value < integ.spectral_eps))
+                    unconverged_tips.push_back(i);
+            }
+            tips = unconverged_tips;
+        }
+
+        return series_params;
+    }
+} // namespace River
+
+#endif
@@ -0,0 +1,201 @@
+/*
+    riversim - river growth simulation.
+    Copyright (c) 2019 Oleg Kmechak
+    Report issues: github.com/okmechak/RiverSim/issues
+
+    This program is free software; you can redistribute it and/or
+    modify it under the terms of the GNU General Public License
+    as published by the Free Software Foundation; either version 2
+    of the License, or (at your option) any later version.
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+    GNU General Public License for more details.
+ */
+
+/*! \file distributed_solver.hpp
+    \brief PDE solver on triangulation distributed between MPI processes.
+    \details Program run by several MPI processes(e.g. "mpirun -np 4 ./riversim ...") generates same boundary and
+    mesh on each of them, and only refined triangulation, degrees of freedom, matrix and vectors are split between processes.
+    River::DistributedSolver is available if Deal.II is built with p4est and Trilinos.
+*/
+#pragma once
+
+#include "solver.hpp"
+
+///\cond
+#include <deal.II/base/mpi.h>
+#include <deal.II/base/utilities.h>
+///\endcond
+
+#if defined(DEAL_II_WITH_P4EST) && defined(DEAL_II_WITH_TRILINOS)
+/// Defined if River::DistributedSolver is available.
+#define RIVERSIM_DISTRIBUTED_SOLVER
+
+///\cond
+#include <deal.II/base/index_set.h>
+#include <deal.II/base/bounding_box.h>
+#include <deal.II/distributed/tria.h>
+#include <deal.II/grid/grid_tools.h>
+#include <deal.II/grid/grid_tools_cache.h>
+#include <deal.II/grid/filtered_iterator.h>
+#include <deal.II/lac/sparsity_tools.h>
+#include <deal.II/lac/trilinos_sparse_matrix.h>
+#include <deal.II/lac/trilinos_vector.h>
+#include <deal.II/lac/trilinos_precondition.h>
+///\endcond
+#endif
+
+namespace River
+{
+    /// Number of MPI processes of program, one if MPI isn't initialized(e.g. in Python API).
+    inline unsigned NumberOfProcesses()
+    {
+        return Utilities::MPI::job_supports_mpi() ? Utilities::MPI::n_mpi_processes(MPI_COMM_WORLD) : 1;
+    }
+
+    /// Rank of current MPI process, zero if MPI isn't initialized.
+    inline unsigned ProcessRank()
+    {
+        return Utilities::MPI::job_supports_mpi() ? Utilities::MPI::this_mpi_process(MPI_COMM_WORLD) : 0;
+    }
+
+#ifdef RIVERSIM_DISTRIBUTED_SOLVER
+    /*! \brief Solves same problem as River::Solver on parallel::distributed::Triangulation.
+        \details Coarse mesh from Triangle is known to all processes, p4est splits its static refinment between them, so
+        each process assembles its locally owned cells into Trilinos matrix, and system is solved by MPI parallel CG.
+        All methods are collective and should be called by all processes with same arguments.
+
+        Series parameters of all tips are integrated at once(see integrate_tips()): each sample point is evaluated by
+        process which owns cell of point, and values are summed over processes, so each process gets same series parameters.
+    */
+    class DistributedSolver
+    {
+    public:
+        DistributedSolver(const SolverParams &solver_params, const MPI_Comm mpi_communicator = MPI_COMM_WORLD, const bool verbose = false);
+
+        ~DistributedSolver() { clear(); }
+
+        /// Solver tollerance
+        double tollerance = 1e-12;
+
+        /// Number of solver iterations.
+        unsigned number_of_iterations = 6000;
+
+        /// Preconditioner of CG solver(0 - block SSOR, 1 - Jacobi, 2 - algebraic multigrid).
+        unsigned preconditioner_type = 0;
+
+        /// Outer field value. See Puasson, Laplace equations.
+        double field_value = 0.;
+
+        /// Number of CG iterations done by last call of run().
+        unsigned number_of_solver_iterations = 0;
+
+        /// Time of solver phases, named as subphases of "OpenMesh", "Solve" and "Integration".
+        Timers timers;
+
+        /// Creates coarse triangulation from \p mesh, each process should pass same mesh.
+        void OpenMesh(const tethex::FlatMesh &mesh);
+
+        /// Static refinment around tips, cells are refined by processes which own them.
+        void static_refine_grid(unsigned int num_of_static_refinments, const double integration_radius, const t_PointList &tips_points);
+
+        ///Sets boundary conditions of solver.
+        void setBoundaryConditions(const BoundaryConditions &boundary_conds);
+
+        /// Distributes degrees of freedom, assembles and solves system.
+        void run();
+
+        /*! \brief Each process writes its part of solution to "<file_name>_<rank>.vtu", root process writes "<file_name>.pvtu",
+            which joins them.
+        */
+        void output_results(const string file_name) const;
+
+        /*! \brief Series parameters of tips in \p tips_points with directions \p tips_angles.
+            \details Stencil method(see River::Solver::integrate_new()) or, if IntegrationParams::integration_method is 1,
+            nested Fejer grids(see River::Solver::integrate_spectral()) are used. Spectral grids are doubled
+            for all tips, which haven't converged, together, and only new samples of each level are evaluated.
+        */
+        vector<vector<double>> integrate_tips(const IntegrationParams &integ, const t_PointList &tips_points, const vector<double> &tips_angles);
+
+        /*! \brief Values of solution at \p points, each process gets same values.
+            \param[out] point_values Values at \p points, zero if point is outside of region.
+            \param[out] mask One if point is inside of region, zero otherwise.
+        */
+        void values(const t_PointList &points, vector<double> &point_values, vector<double> &mask) const;
+
+        /// Number of active cells of whole triangulation.
+        unsigned long NumberOfRefinedCells() const
+        {
+            return triangulation.n_global_active_cells();
+        }
+
+        unsigned long NumberOfDOFs() const
+        {
+            return dof_handler.n_dofs();
+        }
+
+        bool solved() const
+        {
+            return locally_relevant_solution.size() > 0;
+        }
+
+        /// Clear Solver object.
+        void clear();
+
+    private:
+        /// Dimension of problem.
+        const static int dim = 2;
+
+        MPI_Comm mpi_communicator;
+
+        parallel::distributed::Triangulation<dim> triangulation;
+
+        /// Point location in triangulation, updated by triangulation changes.
+        GridTools::Cache<dim> cache;
+
+        DoFHandler<dim> dof_handler;
+        FE_Q<dim> fe;
+        QGauss<dim> quadrature_formula;
+        QGauss<dim - 1> face_quadrature_formula;
+        /// If true, output will be produced to stadard output.
+        bool verbose = false;
+        BoundaryConditions boundary_conditions;
+
+        IndexSet locally_owned_dofs, locally_relevant_dofs;
+
+        /// Hanging nodes and Dirichlet values.
+        AffineConstraints<double> constraints;
+
+        TrilinosWrappers::SparseMatrix system_matrix;
+        TrilinosWrappers::MPI::Vector system_rhs;
+
+        /// Solution with ghost values of all cells adjacent to locally owned ones.
+        TrilinosWrappers::MPI::Vector locally_relevant_solution;
+
+        /// Bounding boxes of locally owned cells, points outside of them are skipped by local_values().
+        vector<BoundingBox<dim>> locally_owned_boxes;
+
+        void setup_system();
+        void assemble_system();
+        void solve();
+
+        /*! \brief Values of solution at \p points, which lie in locally owned cells.
+            \param[out] point_values Values at \p points, zero if point isn't in locally owned cell.
+            \param[out] mask One if point is in locally owned cell, zero otherwise.
+        */
+        void local_values(const t_PointList &points, vector<double> &point_values, vector<double> &mask) const;
+
+        /// Sums results of local_values() over processes, so each process gets values at all points.
+        void reduce_values(vector<double> &point_values, vector<double> &mask) const;
+
+        /*! \brief Integrates series parameters with \p stencil for tips with indices \p tips, results are saved into \p series_params.
+            \details Values and mask of samples, which are already in \p tips_values and \p tips_mask(samples of previous
+            level of nested stencil), are reused, and rest of samples are evaluated and appended to them.
+        */
+        void integrate_stencil(const IntegrationStencil &stencil, const t_PointList &tips_points, const vector<double> &tips_angles,
+            const vector<size_t> &tips, vector<vector<double>> &tips_values, vector<vector<double>> &tips_mask,
+            vector<vector<double>> &series_params);
+    };
+#endif
+} // namespace River
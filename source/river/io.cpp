@@ -117,8 +117,17 @@ namespace River
             value<bool>()->default_value(bool_to_string(prog_opt.save_each_step)) )
         ("vtk", "Outputs VTK file of Deal.II solution", 
             value<bool>()->default_value(bool_to_string(prog_opt.save_vtk)) )
+        ("mesh-output", "Format of mesh file saved at each step: 0 - none, 1 - text MSH 2.2, 2 - binary MSH 2.2, 3 - binary MSH 4.1", 
+            value<unsigned>()->default_value(to_string(prog_opt.mesh_output_format)) )
+        ("output-queue", "Maximal number of output files(JSON, VTK) queued for writing in background thread while next steps are simulated, 0 - files are written synchronously.", 
+            value<unsigned>()->default_value(to_string(prog_opt.output_queue_size)) )
+        ("journal", "Append record of each step to {output}.journal instead of saving whole state at each step. Value is period in steps of full snapshots of state, 0 - journal isn't written. Journal can be opened as input.", 
+            value<unsigned>()->default_value(to_string(prog_opt.journal_snapshot_period)) )
         ("input",
             "input simaultion data, boundary, rivers, model parameters. It has very similar structure as output json of program.", 
+            value<string>() )
+        ("ensemble",
+            "JSON file with list of runs(partial model parameters, program options), which are simulated in parallel in one process. Summary is saved to {output}_ensemble.json.", 
             value<string>() );
         
         //prints and logs
@@ -180,7 +189,13 @@ namespace River
         ("integration-radius", "Radius of integration around tips for evaluation of series parameters", 
             value<double>()->default_value(to_string(model.integr.integration_radius)) )
         ("weight-radius", "Parameter used in integration weight function. Weight radius parameter. For more details please see FreeFem implementation.", 
-            value<double>()->default_value(to_string(model.integr.weigth_func_radius)) );
+            value<double>()->default_value(to_string(model.integr.weigth_func_radius)) )
+        ("integration-method", "Integration method of series parameters: 0 - uniform polar grid, 1 - nested Fejer grids with target accuracy.", 
+            value<unsigned>()->default_value(to_string(model.integr.integration_method)) )
+        ("spectral-eps", "Target relative accuracy of series parameters for nested Fejer grids integration method.", 
+            value<double>()->default_value(to_string(model.integr.spectral_eps)) )
+        ("spectral-max-levels", "Maximal number of doublings of nested Fejer grid, no more then " + to_string(IntegrationParams::spectral_levels_limit) + ".", 
+            value<unsigned>()->default_value(to_string(model.integr.spectral_max_levels)) );
 
         //Mesh parameters
         options.add_options("Mesh refinment parameters. Funciton of area constaint and its parameters: min_area - (max_area - min_area)*(1 - exp( - 1/(2*{mesh-sigma}^2)*(r/ro)^{mesh-exp})/(1 + exp( -1/(2*{mesh-sigma}^2)*(r/ro)^{mesh-exp}).")
@@ -205,7 +220,11 @@ namespace River
         ("smoothness-degree", "Smoothnes minimal degree. This value sets threshold for degree between adjacent points below which it should be ignored. This creates smaller mesh.", 
             value<double>()->default_value(to_string(model.mesh_params.smoothness_degree)) )
         ("ignored-smoothness-length", "Smoothnes minimal length. This value sets threshold for length where smoothnest near tip will be ignored. Ideally it should be bigger then integration radius.", 
-            value<double>()->default_value(to_string(model.mesh_params.ignored_smoothness_length)) );
+            value<double>()->default_value(to_string(model.mesh_params.ignored_smoothness_length)) )
+        ("remeshing-radius", "If positive, then at each step only region closer then this radius to tips or changed boundary is triangulated again. Zero value disables incremental remeshing.", 
+            value<double>()->default_value(to_string(model.mesh_params.remeshing_radius)) )
+        ("full-remeshing-period", "Number of incremental remeshing steps after which whole region is triangulated again. Zero value means no limit.", 
+            value<unsigned>()->default_value(to_string(model.mesh_params.full_remeshing_period)) );
         
         
         //Solver parameters
@@ -220,6 +239,20 @@ namespace River
             value<double>()->default_value(to_string(model.solver_params.refinment_fraction)))
         ("static-refinment-steps", "Number of mesh refinment steps used by Deal.II mesh functionality.", 
             value<unsigned>()->default_value(to_string(model.solver_params.static_refinment_steps)) )
+        ("preconditioner", "Preconditioner of CG solver: 0 - SSOR, 1 - Jacobi, 2 - algebraic multigrid(needs Deal.II built with Trilinos), 3 - geometric multigrid over levels of static refinment.", 
+            value<unsigned>()->default_value(to_string(model.solver_params.preconditioner_type)))
+        ("warm-start", "Initial guess of CG solver is interpolated from solution of previous growth step.", 
+            value<bool>()->default_value(bool_to_string(model.solver_params.warm_start)))
+        ("threads", "Number of threads used by Deal.II system assembly. 0 - all available cores.", 
+            value<unsigned>()->default_value(to_string(model.solver_params.num_of_threads)))
+        ("matrix-free", "Laplace operator is applied matrix free without storing system matrix. Works with quadrature-degree from 1 to 4.", 
+            value<bool>()->default_value(bool_to_string(model.solver_params.matrix_free)))
+        ("condensation-radius", "Radius around tips of zone, which is solved at each step, rest of region is condensed into Schur complement and reused between steps. 0 - whole region is solved.", 
+            value<double>()->default_value(to_string(model.solver_params.condensation_radius)))
+        ("mixed-precision", "CG iterations and preconditioner run in single precision, solution is corrected by double precision residual till tollerance is reached. Works with SSOR and Jacobi preconditioners.", 
+            value<bool>()->default_value(bool_to_string(model.solver_params.mixed_precision)))
+        ("direct-solver", "System is solved by sparse direct solver UMFPACK(needs Deal.II built with it) instead of CG. Factorization is reused while system matrix is the same.", 
+            value<bool>()->default_value(bool_to_string(model.solver_params.direct_solver)))
         ("adaptive-refinment-steps", "Number of refinment steps used by adaptive Deal.II mesh functionality.", 
             value<unsigned>()->default_value(to_string(model.solver_params.adaptive_refinment_steps)))
         ("max-dist", "Used by non-euler solver.", 
@@ -281,11 +314,16 @@ namespace River
         if (vm.count("mesh-ratio")) model.mesh_params.ratio = vm["mesh-ratio"].as<double>();
         if (vm.count("smoothness-degree")) model.mesh_params.smoothness_degree = vm["smoothness-degree"].as<double>();
         if (vm.count("ignored-smoothness-length")) model.mesh_params.ignored_smoothness_length = vm["ignored-smoothness-length"].as<double>();
+        if (vm.count("remeshing-radius")) model.mesh_params.remeshing_radius = vm["remeshing-radius"].as<double>();
+        if (vm.count("full-remeshing-period")) model.mesh_params.full_remeshing_period = vm["full-remeshing-period"].as<unsigned>();
         
         //integration options
         if (vm.count("integration-radius")) model.integr.integration_radius = vm["integration-radius"].as<double>();
         if (vm.count("weight-radius")) model.integr.weigth_func_radius = vm["weight-radius"].as<double>();
         if (vm.count("weight-exp")) model.integr.exponant = vm["weight-exp"].as<double>();
+        if (vm.count("integration-method")) model.integr.integration_method = vm["integration-method"].as<unsigned>();
+        if (vm.count("spectral-eps")) model.integr.spectral_eps = vm["spectral-eps"].as<double>();
+        if (vm.count("spectral-max-levels")) model.integr.spectral_max_levels = vm["spectral-max-levels"].as<unsigned>();
 
         //solver options
         if (vm.count("tol")) model.solver_params.tollerance = vm["tol"].as<double>();
@@ -294,6 +332,13 @@ namespace River
         if (vm.count("static-refinment-steps")) model.solver_params.static_refinment_steps = vm["static-refinment-steps"].as<unsigned>();
         if (vm.count("refinment-fraction")) model.solver_params.refinment_fraction = vm["refinment-fraction"].as<double>();
         if (vm.count("quadrature-degree")) model.solver_params.quadrature_degree = vm["quadrature-degree"].as<unsigned>();
+        if (vm.count("preconditioner")) model.solver_params.preconditioner_type = vm["preconditioner"].as<unsigned>();
+        if (vm.count("warm-start")) model.solver_params.warm_start = vm["warm-start"].as<bool>();
+        if (vm.count("threads")) model.solver_params.num_of_threads = vm["threads"].as<unsigned>();
+        if (vm.count("matrix-free")) model.solver_params.matrix_free = vm["matrix-free"].as<bool>();
+        if (vm.count("condensation-radius")) model.solver_params.condensation_radius = vm["condensation-radius"].as<double>();
+        if (vm.count("mixed-precision")) model.solver_params.mixed_precision = vm["mixed-precision"].as<bool>();
+        if (vm.count("direct-solver")) model.solver_params.direct_solver = vm["direct-solver"].as<bool>();
         if (vm.count("max-dist")) model.solver_params.max_distance = vm["max-dist"].as<double>();
         if (vm.count("field-value")) model.solver_params.field_value = vm["field-value"].as<double>();
 
@@ -332,6 +377,11 @@ namespace River
         if (vm.count("output")) prog_opt.output_file_name = vm["output"].as<string>();
         if (vm.count("input")) prog_opt.input_file_name = vm["input"].as<string>();
         prog_opt.save_each_step = vm.count("save-each-step");
+        if (vm.count("mesh-output")) prog_opt.mesh_output_format = vm["mesh-output"].as<unsigned>();
+        if (vm.count("output-queue")) prog_opt.output_queue_size = vm["output-queue"].as<unsigned>();
+        if (vm.count("journal")) prog_opt.journal_snapshot_period = vm["journal"].as<unsigned>();
+        if (prog_opt.mesh_output_format > 3)
+            throw Exception("Unknown mesh output format: " + to_string(prog_opt.mesh_output_format));
 
         return prog_opt;
     }
@@ -344,6 +394,9 @@ namespace River
         write << "\t output_file_name = "         << po.output_file_name << endl;
         write << "\t input_file_name = "          << po.input_file_name  << endl;
         write << "\t save each step = "              << po.save_each_step   << endl; 
+        write << "\t mesh_output_format = "       << po.mesh_output_format << endl;
+        write << "\t output_queue_size = "        << po.output_queue_size << endl;
+        write << "\t journal_snapshot_period = "  << po.journal_snapshot_period << endl;
         return write;
     }
 
@@ -352,6 +405,9 @@ namespace River
         return 
             save_vtk == po.save_vtk
             && save_each_step == po.save_each_step
+            && mesh_output_format == po.mesh_output_format
+            && output_queue_size == po.output_queue_size
+            && journal_snapshot_period == po.journal_snapshot_period
             && verbose == po.verbose
             //&& output_file_name == po.output_file_name
             && input_file_name == po.input_file_name;
@@ -585,6 +641,9 @@ namespace River
             //{"number_of_backward_steps", data.number_of_backward_steps},
             {"save_vtk", data.save_vtk},
             {"save_each_step", data.save_each_step},
+            {"mesh_output_format", data.mesh_output_format},
+            {"output_queue_size", data.output_queue_size},
+            {"journal_snapshot_period", data.journal_snapshot_period},
             {"verbose", data.verbose},
             {"debug", data.debug},
             {"output_file_name", data.output_file_name},
@@ -598,6 +657,9 @@ namespace River
         //if(j.count("number_of_backward_steps")) j.at("number_of_backward_steps").get_to(data.number_of_backward_steps);
         if(j.count("save_vtk")) j.at("save_vtk").get_to(data.save_vtk);
         if(j.count("save_each_step")) j.at("save_each_step").get_to(data.save_each_step);
+        if(j.count("mesh_output_format")) j.at("mesh_output_format").get_to(data.mesh_output_format);
+        if(j.count("output_queue_size")) j.at("output_queue_size").get_to(data.output_queue_size);
+        if(j.count("journal_snapshot_period")) j.at("journal_snapshot_period").get_to(data.journal_snapshot_period);
         if(j.count("verbose")) j.at("verbose").get_to(data.verbose);
         if(j.count("debug")) j.at("debug").get_to(data.debug);
         if(j.count("input_file_name")) j.at("input_file_name").get_to(data.input_file_name);
@@ -618,7 +680,9 @@ namespace River
             {"min_edge", data.min_edge},
             {"ratio", data.ratio},
             {"smoothness_degree", data.smoothness_degree},
-            {"ignored_smoothness_length", data.ignored_smoothness_length}};
+            {"ignored_smoothness_length", data.ignored_smoothness_length},
+            {"remeshing_radius", data.remeshing_radius},
+            {"full_remeshing_period", data.full_remeshing_period}};
     }
 
     void from_json(const json& j, MeshParams& data) 
@@ -634,6 +698,8 @@ namespace River
         if(j.count("ratio")) j.at("ratio").get_to(data.ratio);
         if(j.count("smoothness_degree")) j.at("smoothness_degree").get_to(data.smoothness_degree);
         if(j.count("ignored_smoothness_length")) j.at("ignored_smoothness_length").get_to(data.ignored_smoothness_length);
+        if(j.count("remeshing_radius")) j.at("remeshing_radius").get_to(data.remeshing_radius);
+        if(j.count("full_remeshing_period")) j.at("full_remeshing_period").get_to(data.full_remeshing_period);
     }
 
     //IntegrationParams
@@ -642,13 +708,19 @@ namespace River
         j = json{
             {"weigth_func_radius", data.weigth_func_radius},
             {"integration_radius", data.integration_radius},
-            {"exponant", data.exponant}};
+            {"exponant", data.exponant},
+            {"integration_method", data.integration_method},
+            {"spectral_eps", data.spectral_eps},
+            {"spectral_max_levels", data.spectral_max_levels}};
     }
     void from_json(const json& j, IntegrationParams& data) 
     {
         if(j.count("weigth_func_radius")) j.at("weigth_func_radius").get_to(data.weigth_func_radius);
         if(j.count("integration_radius")) j.at("integration_radius").get_to(data.integration_radius);
         if(j.count("exponant")) j.at("exponant").get_to(data.exponant);
+        if(j.count("integration_method")) j.at("integration_method").get_to(data.integration_method);
+        if(j.count("spectral_eps")) j.at("spectral_eps").get_to(data.spectral_eps);
+        if(j.count("spectral_max_levels")) j.at("spectral_max_levels").get_to(data.spectral_max_levels);
     }
 
     //SolverParams
@@ -662,6 +734,13 @@ namespace River
             {"refinment_fraction", data.refinment_fraction},
             {"quadrature_degree", data.quadrature_degree},
             {"renumbering_type", data.renumbering_type},
+            {"preconditioner_type", data.preconditioner_type},
+            {"warm_start", data.warm_start},
+            {"num_of_threads", data.num_of_threads},
+            {"matrix_free", data.matrix_free},
+            {"condensation_radius", data.condensation_radius},
+            {"mixed_precision", data.mixed_precision},
+            {"direct_solver", data.direct_solver},
             {"max_distance", data.max_distance},
             {"field_value", data.field_value}};
     }
@@ -675,6 +754,13 @@ namespace River
         if(j.count("refinment_fraction")) j.at("refinment_fraction").get_to(data.refinment_fraction);
         if(j.count("quadrature_degree")) j.at("quadrature_degree").get_to(data.quadrature_degree);
         if(j.count("renumbering_type")) j.at("renumbering_type").get_to(data.renumbering_type);
+        if(j.count("preconditioner_type")) j.at("preconditioner_type").get_to(data.preconditioner_type);
+        if(j.count("warm_start")) j.at("warm_start").get_to(data.warm_start);
+        if(j.count("num_of_threads")) j.at("num_of_threads").get_to(data.num_of_threads);
+        if(j.count("matrix_free")) j.at("matrix_free").get_to(data.matrix_free);
+        if(j.count("condensation_radius")) j.at("condensation_radius").get_to(data.condensation_radius);
+        if(j.count("mixed_precision")) j.at("mixed_precision").get_to(data.mixed_precision);
+        if(j.count("direct_solver")) j.at("direct_solver").get_to(data.direct_solver);
         if(j.count("max_distance")) j.at("max_distance").get_to(data.max_distance);
         if(j.count("field_value")) j.at("field_value").get_to(data.field_value);
     }
@@ -766,13 +852,20 @@ namespace River
 
     void Open(Model& model, const string file_name)
     {
-        ifstream in(file_name);
-        if(!in) throw Exception("Open. Can't create file for read. : " + file_name);
+        const string journal_extension = ".journal";
+        if (file_name.size() > journal_extension.size() 
+            && file_name.compare(file_name.size() - journal_extension.size(), journal_extension.size(), journal_extension) == 0)
+            OpenJournal(model, file_name);
+        else
+        {
+            ifstream in(file_name);
+            if(!in) throw Exception("Open. Can't create file for read. : " + file_name);
 
-        json j;
-        in >> j;
+            json j;
+            in >> j;
 
-        j.at("model").get_to(model);
+            j.at("model").get_to(model);
+        }
 
         if (model.sources.empty())
             throw Exception("Open: sources from input file are empty");
@@ -786,4 +879,216 @@ namespace River
         if (model.rivers.empty())
             model.rivers.Initialize(model.region.GetSourcesIdsPointsAndAngles(model.sources));
     }
+
+    //Journal
+    ///Changes of \p current relative to \p last: length of their common beginning and values of \p current after it.
+    template<typename T, typename Equal>
+    json vector_diff(const vector<T>& last, const vector<T>& current, Equal equal)
+    {
+        size_t from = 0;
+        while (from < last.size() && from < current.size() && equal(last[from], current[from]))
+            ++from;
+
+        return json{
+            {"from", from},
+            {"values", vector<T>(current.begin() + from, current.end())}};
+    }
+
+    ///True if \p diff of vector_diff changes vector of \p last_size length.
+    bool is_changed(const json& diff, const size_t last_size)
+    {
+        return diff.at("from").get<size_t>() != last_size || !diff.at("values").empty();
+    }
+
+    ///Applies changes of vector_diff to \p data.
+    template<typename T>
+    void apply_vector_diff(vector<T>& data, const json& diff)
+    {
+        data.resize(diff.at("from").get<size_t>());
+        for (const auto& value: diff.at("values"))
+            data.push_back(value.get<T>());
+    }
+
+    bool Journal::IsNextRecordFull() const
+    {
+        return n_records == 0 || (snapshot_period > 0 && n_records % snapshot_period == 0);
+    }
+
+    json Journal::Record(const Model& model)
+    {
+        json record = {{"step", n_records}};
+
+        if (IsNextRecordFull())
+        {
+            record["full"] = true;
+            record["model"] = model;
+        }
+        else
+        {
+            // exact comparison, so reconstructed state is the same as saved one
+            auto same_point = [](const Point& a, const Point& b){ return a.x == b.x && a.y == b.y; };
+            auto same_line = [](const Line& a, const Line& b){ return a.p1 == b.p1 && a.p2 == b.p2 && a.boundary_id == b.boundary_id; };
+            auto same_value = [](const double a, const double b){ return a == b; };
+            const Branch empty_branch{};
+            const vector<vector<double>> empty_series_params;
+            const vector<double> empty_values;
+
+            for (const auto&[id, branch]: model.rivers)
+            {
+                const auto& last_branch = last_rivers.count(id) ? last_rivers.at(id) : empty_branch;
+                auto vertices = vector_diff(last_branch.vertices, branch.vertices, same_point);
+                auto lines = vector_diff(last_branch.lines, branch.lines, same_line);
+                if (last_rivers.count(id)
+                    && !is_changed(vertices, last_branch.vertices.size())
+                    && !is_changed(lines, last_branch.lines.size())
+                    && last_branch.SourceAngle() == branch.SourceAngle())
+                    continue;
+
+                record["rivers"].push_back({
+                    {"id", id},
+                    {"vertices", vertices},
+                    {"lines", lines},
+                    {"source_angle", branch.SourceAngle()}});
+            }
+            for (const auto&[id, branch]: last_rivers)
+                if (!model.rivers.count(id))
+                    record["removed_branches"].push_back(id);
+            if (model.rivers.branches_relation != last_rivers.branches_relation)
+                record["relations"] = model.rivers.branches_relation;
+
+            for (const auto&[id, series_params]: model.series_parameters)
+            {
+                const auto& last_series_params = last_series_parameters.count(id) ? last_series_parameters.at(id) : empty_series_params;
+                json values;
+                bool changed = series_params.size() != last_series_params.size();
+                for (size_t i = 0; i < series_params.size(); ++i)
+                {
+                    const auto& last_values = i < last_series_params.size() ? last_series_params[i] : empty_values;
+                    values.push_back(vector_diff(last_values, series_params[i], same_value));
+                    changed = changed || is_changed(values.back(), last_values.size());
+                }
+                if (changed)
+                    record["series_parameters"].push_back({{"id", id}, {"values", values}});
+            }
+
+            for (const auto&[key, values]: model.sim_data)
+            {
+                const auto& last_values = last_sim_data.count(key) ? last_sim_data.at(key) : empty_values;
+                auto diff = vector_diff(last_values, values, same_value);
+                if (is_changed(diff, last_values.size()))
+                    record["simulation_data"][key] = diff;
+            }
+
+            for (const auto&[id, data]: model.backward_data)
+                if (!last_backward_data.count(id) || !(last_backward_data.at(id) == data))
+                    record["backward_data"].push_back({{"id", id}, {"data", data}});
+        }
+
+        last_rivers = model.rivers;
+        last_series_parameters = model.series_parameters;
+        last_sim_data = model.sim_data;
+        last_backward_data = model.backward_data;
+        ++n_records;
+
+        return record;
+    }
+
+    ///Applies changes of step record of River::Journal to \p model.
+    void apply_journal_record(Model& model, const json& record)
+    {
+        if (record.count("removed_branches"))
+            for (const auto& id: record.at("removed_branches"))
+                model.rivers.erase(id.get<t_branch_id>());
+
+        if (record.count("rivers"))
+            for (const auto& branch_diff: record.at("rivers"))
+            {
+                auto& branch = model.rivers[branch_diff.at("id").get<t_branch_id>()];
+                apply_vector_diff(branch.vertices, branch_diff.at("vertices"));
+                apply_vector_diff(branch.lines, branch_diff.at("lines"));
+                branch.SetSourceAngle(branch_diff.at("source_angle").get<double>());
+            }
+
+        if (record.count("relations"))
+        {
+            model.rivers.branches_relation.clear();
+            record.at("relations").get_to(model.rivers.branches_relation);
+        }
+
+        if (record.count("series_parameters"))
+            for (const auto& series_diff: record.at("series_parameters"))
+            {
+                auto& series_params = model.series_parameters[series_diff.at("id").get<t_branch_id>()];
+                const auto& values = series_diff.at("values");
+                series_params.resize(values.size());
+                for (size_t i = 0; i < values.size(); ++i)
+                    apply_vector_diff(series_params[i], values.at(i));
+            }
+
+        if (record.count("simulation_data"))
+            for (const auto& [key, diff]: record.at("simulation_data").items())
+                apply_vector_diff(model.sim_data[key], diff);
+
+        if (record.count("backward_data"))
+            for (const auto& backward_diff: record.at("backward_data"))
+                backward_diff.at("data").get_to(model.backward_data[backward_diff.at("id").get<t_branch_id>()]);
+    }
+
+    /*! \brief Checks if \p line is record of River::Journal and if it is full one.
+        \details Only top level "full" field is stored while line is parsed, so model of full record isn't built.
+        \return False if line isn't valid JSON object.
+    */
+    bool parse_journal_record_kind(const string& line, bool& is_full)
+    {
+        const auto record = json::parse(line, [](int depth, json::parse_event_t event, json& parsed)
+        {
+            return depth != 1 || event != json::parse_event_t::key || parsed == "full";
+        }, false);
+        if (record.is_discarded() || !record.is_object())
+            return false;
+
+        is_full = record.count("full") && record.at("full").is_boolean() && record.at("full").get<bool>();
+        return true;
+    }
+
+    void OpenJournal(Model& model, const string file_name, const int step)
+    {
+        ifstream in(file_name);
+        if(!in) throw Exception("OpenJournal: Can't open file for read: " + file_name);
+
+        vector<string> records;
+        bool has_full_record = false;
+        int n_steps = 0;
+        for (string line; (step < 0 || n_steps <= step) && getline(in, line);)
+        {
+            if (line.empty())
+                continue;
+
+            bool is_full = false;
+            if (!parse_journal_record_kind(line, is_full))
+            {
+                // record is appended at once, so only last one can be cut by interrupted run
+                if (in.peek() == char_traits<char>::eof())
+                    break;
+                throw Exception("OpenJournal: journal " + file_name + " has invalid record of step " + to_string(n_steps));
+            }
+
+            if (is_full)
+            {
+                records.clear();
+                has_full_record = true;
+            }
+            records.push_back(move(line));
+            ++n_steps;
+        }
+
+        if (step >= 0 && n_steps <= step)
+            throw Exception("OpenJournal: journal " + file_name + " has only " + to_string(n_steps) + " steps");
+        if (!has_full_record)
+            throw Exception("OpenJournal: journal " + file_name + " has no full record");
+
+        json::parse(records.front()).at("model").get_to(model);
+        for (size_t i = 1; i < records.size(); ++i)
+            apply_journal_record(model, json::parse(records[i]));
+    }
 }//namespace River
\ No newline at end of file
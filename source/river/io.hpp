@@ -252,6 +252,15 @@ namespace River
 
             bool save_each_step = false;
 
+            ///Format of mesh file saved at each step: 0 - none, 1 - text MSH 2.2, 2 - binary MSH 2.2, 3 - binary MSH 4.1.
+            unsigned mesh_output_format = 0;
+
+            ///Maximal number of output files(JSON, VTK) queued for writing in background, 0 - files are written synchronously.
+            unsigned output_queue_size = 2;
+
+            ///Period in steps of full snapshots of River::Journal, 0 - journal isn't written and whole state is saved at each step.
+            unsigned journal_snapshot_period = 0;
+
             ///If true - then program will print to standard output.
             bool verbose = true;
 
@@ -277,8 +286,53 @@ namespace River
     void Save(const Model& model, const string file_name);
     
     ///Opens state of program from json file which includes Geometry(Rivers, Boundary) and current model parameters(Model).
+    ///File with ".journal" extension is opened by River::OpenJournal at its last step.
     void Open(Model& model, const string file_name);
 
+    /*! \brief Append-only journal of simulation steps.
+        \details Each line of journal file is compact JSON record of model state after one step. Full record
+        {"full": true, "model": ..., "step": n} holds whole model(same as River::Save) and is written at first step and each
+        snapshot_period steps. Other records hold only changes since previous record: for vertices and lines of branches,
+        series parameters and simulation data it is length of unchanged beginning("from") and values after it, so
+        growth, reverting of tip points and removal of branches are recorded, while size of record doesn't grow
+        with number of steps. Parameters, region and sources are taken from full record.
+    */
+    class Journal
+    {
+        public:
+            explicit Journal(const unsigned snapshot_period = 10):
+                snapshot_period{snapshot_period}
+            {}
+
+            ///Returns record of \p model state after next step and remembers state for next record.
+            json Record(const Model& model);
+
+            ///True if next record is full one.
+            bool IsNextRecordFull() const;
+
+            ///Number of recorded steps.
+            unsigned NumberOfRecords() const { return n_records; }
+
+            ///Period in steps of full records, if zero only first record is full.
+            unsigned snapshot_period;
+
+        private:
+            unsigned n_records = 0;
+
+            ///State at last record.
+            Rivers last_rivers;
+            SeriesParameters last_series_parameters;
+            SimulationData last_sim_data;
+            t_GeometryDiffernce last_backward_data;
+    };
+
+    /*! \brief Opens state of model after \p step from journal file written by River::Journal.
+        \details Records are scanned for "full" field, and only last full record before \p step and following
+        records are parsed into model. Invalid last line(e.g. cut by interrupted run) is ignored.
+        \param[in] step Zero based index of step, last step if negative.
+    */
+    void OpenJournal(Model& model, const string file_name, const int step = -1);
+
     void to_json(json& j, const Point& p);
     void from_json(const json& j, Point& p);
 
@@ -482,6 +482,9 @@ namespace River
         if(mesh_params.max_edge < 0.001)
             cout << "mesh max_edge parameter is to small " + to_string(mesh_params.max_edge) << endl;
 
+        if(mesh_params.remeshing_radius < 0)
+            throw Exception("mesh remeshing-radius parameter can't be negative: " + to_string(mesh_params.remeshing_radius));
+
         if(mesh_params.max_edge < mesh_params.min_edge)
             throw Exception("mesh min_edge is bigger than max_edge :" + to_string(mesh_params.min_edge) + ">" + to_string(mesh_params.max_edge));
 
@@ -496,6 +499,15 @@ namespace River
         if(integr.exponant < 0)
             throw Exception("Integration exponant parameter can't be negative: " + to_string(integr.exponant));
 
+        if(integr.integration_method > 1)
+            throw Exception("There is no such integration method: " + to_string(integr.integration_method));
+
+        if(integr.spectral_eps <= 0)
+            throw Exception("Integration spectral_eps parameter should be positive: " + to_string(integr.spectral_eps));
+
+        if(integr.spectral_max_levels > IntegrationParams::spectral_levels_limit)
+            throw Exception("Integration spectral_max_levels parameter can't be greater then " + to_string(IntegrationParams::spectral_levels_limit) + ": " + to_string(integr.spectral_max_levels));
+
 
         //Solver
         if(solver_params.refinment_fraction < 0 || solver_params.refinment_fraction > 1)
@@ -520,6 +532,18 @@ namespace River
 
         if(solver_params.renumbering_type > 7)
             throw Exception("There is no such type of renumbering: " + to_string(solver_params.renumbering_type));
+
+        if(solver_params.matrix_free && (solver_params.quadrature_degree < 1 || solver_params.quadrature_degree > 4))
+            throw Exception("Matrix free solver supports quadrature_degree from 1 to 4: " + to_string(solver_params.quadrature_degree));
+
+        if(solver_params.preconditioner_type > 3)
+            throw Exception("There is no such type of preconditioner: " + to_string(solver_params.preconditioner_type));
+
+        if(solver_params.mixed_precision && solver_params.preconditioner_type > 1)
+            cout << "Mixed precision works with SSOR and Jacobi preconditioners, system is solved in double precision. Preconditioner: " << solver_params.preconditioner_type << endl;
+
+        if(solver_params.condensation_radius < 0)
+            throw Exception("Condensation radius should be non negative: " + to_string(solver_params.condensation_radius));
     }
 
     void Model::clear()
@@ -14,6 +14,9 @@
  */
 
 ///\cond
+#include <mutex>
+#include <fstream>
+#include <iomanip>
 #include <iostream>
 ///\endcond
 
@@ -61,7 +64,25 @@ namespace River
             else
                 throw Exception("Invalid simulation type selected: " + to_string(model.simulation_type));
 
+            // with journal whole state is saved only with its full records
+            if (prog_opt.journal_snapshot_period > 0)
+            {
+                auto timer = timers.scope("Save");
+                save_model(prog_opt.output_file_name);
+            }
+            {
+                auto timer = timers.scope("OutputWait");
+                writer.wait();
+            }
+
             print(verbose, "End of main loop...");
+            if (verbose)
+            {
+                Timers all_timers;
+                for (const auto module_timers: modules_timers())
+                    all_timers += *module_timers;
+                cout << "Time of simulation phases:" << endl << all_timers;
+            }
             print(verbose, "Done.");
         }
         catch (const River::Exception &caught)
@@ -100,37 +121,231 @@ namespace River
     t_ids_series_params RiverSolver::solve_and_evaluate_series_parameters(string output_file_name)
     {
         print(verbose, "Boundary generation...");
-        model.boundary = BoundaryGenerator(
-            model.sources, model.region, model.rivers, model.river_width,
-            model.mesh_params.smoothness_degree, model.mesh_params.ignored_smoothness_length);
+        {
+            auto timer = timers.scope("BoundaryGeneration");
+            model.boundary = BoundaryGenerator(
+                model.sources, model.region, model.rivers, model.river_width,
+                model.mesh_params.smoothness_degree, model.mesh_params.ignored_smoothness_length);
+        }
 
         print(verbose, "Mesh generation...");
-        triangle.mesh_params.tip_points = model.rivers.TipPoints();
-        mesh = triangle.generate_quadrangular_mesh(model.boundary, model.region.holes);
-        mesh.write(output_file_name + ".msh");
+        {
+            auto timer = timers.scope("MeshGeneration");
+            triangle.mesh_params.tip_points = model.rivers.TipPoints();
+            mesh = triangle.update_flat_quadrangular_mesh(model.boundary, model.region.holes);
+        }
+        if (process_rank == 0)
+        {
+            auto timer = timers.scope("MeshOutput");
+            if (prog_opt.mesh_output_format != tethex::MSH_NONE)
+                mesh.write(output_file_name + ".msh", (tethex::MshFormat)prog_opt.mesh_output_format);
+            else if (prog_opt.debug)
+                mesh.write(output_file_name + ".msh");
+        }
+
+#ifdef RIVERSIM_DISTRIBUTED_SOLVER
+        if (distributed_solver)
+            return distributed_solve_and_evaluate_series_parameters(output_file_name);
+#endif
 
         print(verbose, "Solving...");
-        solver.clear();
-        solver.OpenMesh(mesh);
-        solver.setBoundaryConditions(model.boundary_conditions);
-        //solver.OpenMesh(output_file_name + ".msh");
-        solver.static_refine_grid(model.solver_params.static_refinment_steps, model.integr.integration_radius, model.rivers.TipPoints());
-        solver.run();
+        {
+            auto timer = timers.scope("OpenMesh");
+            // same mesh is solved again e.g. when tip points are reverted and added back in non linear step
+            if (solver.OpenMeshIfChanged(mesh, model.solver_params.static_refinment_steps, model.integr.integration_radius, model.rivers.TipPoints()))
+                print(verbose, "\t mesh is unchanged, degrees of freedom and stiffness matrix are reused");
+            solver.setBoundaryConditions(model.boundary_conditions);
+            //solver.OpenMesh(output_file_name + ".msh");
+        }
+        {
+            auto timer = timers.scope("Solve");
+            solver.run();
+        }
+        timers.count("Solves");
         if (prog_opt.save_vtk || prog_opt.debug)
-            solver.output_results(output_file_name);
+        {
+            auto timer = timers.scope("VtkOutput");
+            solver.output_results(output_file_name, writer);
+        }
 
         print(verbose, "Series parameters integration...");
+        auto integration_timer = timers.scope("Integration");
+        // tips are independent and only read solution, so each one is integrated in separate task
+        const auto tips_ids = model.rivers.TipBranchesIds();
+        vector<vector<double>> tips_series_params(tips_ids.size());
+        vector<double> tips_time(tips_ids.size(), 0);
+
+        Threads::TaskGroup<void> tasks;
+        for (size_t i = 0; i < tips_ids.size(); ++i)
+            tasks += Threads::new_task([this, &tips_ids, &tips_series_params, &tips_time, i]()
+            {
+                const auto start = chrono::steady_clock::now();
+                const auto &branch = model.rivers.at(tips_ids[i]);
+                if (model.integr.integration_method == 1)
+                    tips_series_params[i] = solver.integrate_spectral(model.integr, branch.TipPoint(), branch.TipAngle());
+                else
+                    tips_series_params[i] = solver.integrate_new(model.integr, branch.TipPoint(), branch.TipAngle());
+                tips_time[i] = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+            });
+        tasks.join_all();
+
         t_ids_series_params id_series_params;
-        for (const auto id : model.rivers.TipBranchesIds())
+        tips_integration_time.clear();
+        for (size_t i = 0; i < tips_ids.size(); ++i)
         {
-            auto tip_point = model.rivers.at(id).TipPoint();
-            auto tip_angle = model.rivers.at(id).TipAngle();
-            id_series_params[id] = solver.integrate_new(model.integr, tip_point, tip_angle);
+            id_series_params[tips_ids[i]] = tips_series_params[i];
+            tips_integration_time[tips_ids[i]] = tips_time[i];
+            print(verbose, "\t tip " + to_string(tips_ids[i]) + " integration time: " + to_string(tips_time[i]) + " s");
         }
 
         return id_series_params;
     }
 
+#ifdef RIVERSIM_DISTRIBUTED_SOLVER
+    t_ids_series_params RiverSolver::distributed_solve_and_evaluate_series_parameters(const string &output_file_name)
+    {
+        print(verbose, "Solving by " + to_string(NumberOfProcesses()) + " MPI processes...");
+        {
+            auto timer = timers.scope("OpenMesh");
+            distributed_solver->clear();
+            distributed_solver->OpenMesh(mesh);
+            distributed_solver->static_refine_grid(model.solver_params.static_refinment_steps, model.integr.integration_radius, model.rivers.TipPoints());
+            distributed_solver->setBoundaryConditions(model.boundary_conditions);
+        }
+        {
+            auto timer = timers.scope("Solve");
+            distributed_solver->run();
+        }
+        timers.count("Solves");
+        if (prog_opt.save_vtk || prog_opt.debug)
+        {
+            auto timer = timers.scope("VtkOutput");
+            distributed_solver->output_results(output_file_name);
+        }
+
+        print(verbose, "Series parameters integration...");
+        auto integration_timer = timers.scope("Integration");
+        const auto tips_ids = model.rivers.TipBranchesIds();
+        t_PointList tips_points;
+        vector<double> tips_angles;
+        for (const auto &id: tips_ids)
+        {
+            const auto &branch = model.rivers.at(id);
+            tips_points.push_back(branch.TipPoint());
+            tips_angles.push_back(branch.TipAngle());
+        }
+
+        // samples of all tips are evaluated by processes, which own them, and gathered by one reduction
+        const auto tips_series_params = distributed_solver->integrate_tips(model.integr, tips_points, tips_angles);
+
+        t_ids_series_params id_series_params;
+        tips_integration_time.clear();
+        for (size_t i = 0; i < tips_ids.size(); ++i)
+            id_series_params[tips_ids[i]] = tips_series_params[i];
+
+        return id_series_params;
+    }
+#endif
+
+    void RiverSolver::init_distributed_solver()
+    {
+        if (NumberOfProcesses() == 1)
+            return;
+#ifdef RIVERSIM_DISTRIBUTED_SOLVER
+        distributed_solver = make_unique<DistributedSolver>(model.solver_params, MPI_COMM_WORLD, verbose);
+#else
+        throw Exception("RiverSolver: run by several MPI processes needs Deal.II built with p4est and Trilinos.");
+#endif
+    }
+
+    vector<Timers*> RiverSolver::modules_timers()
+    {
+        vector<Timers*> all_timers{&timers, &triangle.timers, &solver.timers};
+#ifdef RIVERSIM_DISTRIBUTED_SOLVER
+        if (distributed_solver)
+            all_timers.push_back(&distributed_solver->timers);
+#endif
+        return all_timers;
+    }
+
+    void RiverSolver::record_solver_data()
+    {
+        auto n_cells = solver.NumberOfRefinedCells(), n_dofs = solver.NumberOfDOFs();
+        auto n_iterations = solver.number_of_solver_iterations;
+#ifdef RIVERSIM_DISTRIBUTED_SOLVER
+        if (distributed_solver)
+        {
+            n_cells = distributed_solver->NumberOfRefinedCells();
+            n_dofs = distributed_solver->NumberOfDOFs();
+            n_iterations = distributed_solver->number_of_solver_iterations;
+        }
+#endif
+        model.sim_data["MeshSize"].push_back(n_cells);
+        model.sim_data["DegreeOfFreedom"].push_back(n_dofs);
+        model.sim_data["SolverIterations"].push_back(n_iterations);
+    }
+
+    void RiverSolver::save_model(const string file_name)
+    {
+        if (process_rank > 0)
+            return;
+
+        // copy is much cheaper than serialization, so step waits only for it
+        auto snapshot = make_shared<const Model>(model);
+        writer.push([snapshot, file_name]()
+        {
+            Save(*snapshot, file_name);
+        });
+    }
+
+    void RiverSolver::save_step(const string file_name)
+    {
+        if (process_rank > 0)
+            return;
+
+        if (prog_opt.journal_snapshot_period == 0)
+        {
+            save_model(file_name);
+            return;
+        }
+
+        const auto is_full_record = journal.IsNextRecordFull(),
+            is_first_record = journal.NumberOfRecords() == 0;
+        auto record = make_shared<const json>(journal.Record(model));
+        const auto journal_file_name = prog_opt.output_file_name + ".journal";
+        writer.push([record, journal_file_name, is_first_record]()
+        {
+            ofstream out(journal_file_name, is_first_record ? ios::trunc : ios::app);
+            if (!out) throw Exception("Journal: Can't create file for write: " + journal_file_name);
+            out << record->dump() << '\n';
+        });
+
+        if (is_full_record || prog_opt.save_each_step)
+            save_model(file_name);
+    }
+
+    void RiverSolver::record_step_timers()
+    {
+        for (auto module_timers: modules_timers())
+        {
+            // phases which appear later are padded by zeros, so all values are aligned by steps
+            for (const auto &[name, phase]: module_timers->phases)
+            {
+                auto &values = model.sim_data["Time/" + name];
+                values.resize(n_timed_steps, 0);
+                values.push_back(phase.step_time);
+            }
+            for (const auto &[name, counter]: module_timers->counters)
+            {
+                auto &values = model.sim_data["Count/" + name];
+                values.resize(n_timed_steps, 0);
+                values.push_back(counter.step_value);
+            }
+            module_timers->next_step();
+        }
+        ++n_timed_steps;
+    }
+
     double RiverSolver::get_max_a1(const t_ids_series_params &id_series_params)
     {
         double max_a = 0.;
@@ -193,7 +408,7 @@ namespace River
                 model.bifurcation_type = bif_type;
 
                 if (prog_opt.debug)
-                    Save(model, output_file_name + "_second_half_step_" + to_string(step));
+                    save_model(output_file_name + "_second_half_step_" + to_string(step));
 
                 if (model.rivers.maximal_tip_curvature_distance() >= model.solver_params.max_distance)
                 {
@@ -260,7 +475,7 @@ namespace River
                 tip_id_series_params = id_series_params;
 
             if (prog_opt.debug)
-                Save(model, output_file_name);
+                save_model(output_file_name);
         }
 
         auto prev_rivers = model.rivers;
@@ -285,7 +500,7 @@ namespace River
             nonLinearStep(output_file_name, max_a1_step1, max_a1_step2);
 
             if (prog_opt.debug)
-                Save(model, prog_opt.output_file_name);
+                save_model(prog_opt.output_file_name);
         }
 
         auto backwardforward_rivers = model.rivers;
@@ -312,10 +527,11 @@ namespace River
             auto id_series_params = linearStep(output_file_name);
 
             model.series_parameters.record(id_series_params);
-            model.sim_data["MeshSize"].push_back(solver.NumberOfRefinedCells());
-            model.sim_data["DegreeOfFreedom"].push_back(solver.NumberOfDOFs());
+            record_solver_data();
+            record_step_timers();
 
-            Save(model, output_file_name);
+            auto timer = timers.scope("Save");
+            save_step(output_file_name);
         }
     }
 
@@ -330,7 +546,10 @@ namespace River
                 output_file_name += "_" + to_string(step);
 
             nonLinearStep(output_file_name);
-            Save(model, output_file_name);
+            record_step_timers();
+
+            auto timer = timers.scope("Save");
+            save_step(output_file_name);
         }
     }
 
@@ -345,7 +564,147 @@ namespace River
                 output_file_name += "_" + to_string(step);
 
             backwardStep();
-            Save(model, output_file_name);
+            record_step_timers();
+
+            auto timer = timers.scope("Save");
+            save_step(output_file_name);
+        }
+    }
+
+    /*
+        Ensemble
+    */
+    int RunEnsemble(const cxxopts::ParseResult &po)
+    {
+        const auto ensemble_file_name = po["ensemble"].as<string>();
+        const auto base_prog_opt = getProgramOptions(po);
+
+        // runs are scheduled differently on each process, so their collective calls wouldn't match
+        if (NumberOfProcesses() > 1)
+        {
+            cout << "RunEnsemble: ensemble is run by one process, start it without mpirun" << endl;
+            return 1;
+        }
+
+        // all runs are prepared before start, so errors in ensemble file are reported at once
+        vector<Model> models;
+        vector<ProgramOptions> prog_opts;
+        unsigned n_threads = 0;
+        try
+        {
+            ifstream in(ensemble_file_name);
+            if (!in) throw Exception("RunEnsemble: can't open ensemble file: " + ensemble_file_name);
+
+            json ensemble;
+            in >> ensemble;
+            if (!ensemble.count("runs") || !ensemble.at("runs").is_array() || ensemble.at("runs").empty())
+                throw Exception("RunEnsemble: ensemble file has no runs: " + ensemble_file_name);
+            if (ensemble.count("threads")) ensemble.at("threads").get_to(n_threads);
+
+            const auto base_model = getModel(po);
+            if (!ensemble.count("threads")) n_threads = base_model.solver_params.num_of_threads;
+
+            const auto &runs = ensemble.at("runs");
+            for (size_t i = 0; i < runs.size(); ++i)
+            {
+                const auto &run = runs.at(i);
+
+                Model model = base_model;
+                if (run.count("input")) Open(model, run.at("input").get<string>());
+                if (ensemble.count("model")) ensemble.at("model").get_to(model);
+                if (run.count("model")) run.at("model").get_to(model);
+                model.CheckParametersConsistency();
+                // thread limit is shared by all runs and set once below
+                model.solver_params.num_of_threads = 0;
+
+                ProgramOptions prog_opt = base_prog_opt;
+                prog_opt.verbose = false;
+                prog_opt.output_file_name = base_prog_opt.output_file_name + "_" + to_string(i);
+                if (run.count("program_options")) run.at("program_options").get_to(prog_opt);
+                if (run.count("output")) run.at("output").get_to(prog_opt.output_file_name);
+
+                models.push_back(model);
+                prog_opts.push_back(prog_opt);
+            }
+        }
+        catch (const River::Exception &caught)
+        {
+            cout << "river excetpion" << endl;
+            cout << caught.what() << endl;
+            return 1;
+        }
+        catch (const std::exception &caught)
+        {
+            cout << "stl exception" << endl;
+            cout << caught.what() << endl;
+            return 3;
         }
+
+        if (n_threads > 0)
+            MultithreadInfo::set_thread_limit(n_threads);
+        print(base_prog_opt.verbose, "Ensemble of " + to_string(models.size()) + " runs on "
+            + to_string(MultithreadInfo::n_threads()) + " threads...");
+
+        const auto start = chrono::steady_clock::now();
+        vector<json> summaries(models.size());
+        mutex print_mutex;
+
+        Threads::TaskGroup<void> tasks;
+        for (size_t i = 0; i < models.size(); ++i)
+            tasks += Threads::new_task([&models, &prog_opts, &summaries, &print_mutex, &base_prog_opt, i]()
+            {
+                const auto run_start = chrono::steady_clock::now();
+                json summary = {{"run", i}, {"output_file_name", prog_opts[i].output_file_name}};
+                try
+                {
+                    RiverSolver river_solver(models[i], prog_opts[i]);
+                    summary["return_code"] = river_solver.run();
+                    summary["number_of_tips"] = river_solver.model.rivers.TipBranchesIds().size();
+                    summary["number_of_branches"] = river_solver.model.rivers.size();
+
+                    Timers all_timers = river_solver.timers;
+                    all_timers += river_solver.triangle.timers;
+                    all_timers += river_solver.solver.timers;
+                    json phases = json::object();
+                    for (const auto &[name, phase]: all_timers.phases)
+                        phases[name] = phase.total_time;
+                    summary["phases"] = phases;
+                }
+                // run() handles its own exceptions, so only construction of solver can get here
+                catch (const std::exception &caught)
+                {
+                    summary["return_code"] = 3;
+                    summary["error"] = caught.what();
+                }
+                summary["wall_time"] = chrono::duration<double>(chrono::steady_clock::now() - run_start).count();
+
+                lock_guard<mutex> lock(print_mutex);
+                print(base_prog_opt.verbose, "\t run " + to_string(i) + " finished with code "
+                    + to_string(summary["return_code"].get<int>()) + " in " + to_string(summary["wall_time"].get<double>()) + " s");
+                summaries[i] = summary;
+            });
+        tasks.join_all();
+
+        const auto n_failed = count_if(summaries.begin(), summaries.end(),
+            [](const json &summary){ return summary["return_code"].get<int>() != 0; });
+
+        json ensemble_summary = {
+            {"ensemble_file_name", ensemble_file_name},
+            {"threads", MultithreadInfo::n_threads()},
+            {"wall_time", chrono::duration<double>(chrono::steady_clock::now() - start).count()},
+            {"number_of_failed_runs", n_failed},
+            {"runs", summaries}};
+
+        const auto summary_file_name = base_prog_opt.output_file_name + "_ensemble.json";
+        ofstream out(summary_file_name);
+        if (!out)
+        {
+            cout << "RunEnsemble: can't create summary file: " << summary_file_name << endl;
+            return 1;
+        }
+        out << setw(4) << ensemble_summary;
+        print(base_prog_opt.verbose, "Done. Summary is saved to " + summary_file_name);
+
+        return n_failed ? 1 : 0;
     }
 }
\ No newline at end of file
@@ -22,7 +22,12 @@
  */
 #pragma once
 
+///\cond
+#include <deal.II/base/thread_management.h>
+///\endcond
+
 #include "io.hpp"
+#include "distributed_solver.hpp"
 
 using namespace std;
 
@@ -39,29 +44,37 @@ namespace River
             RiverSolver(const Model model_in, const ProgramOptions prog_opt): 
                 model{model_in}, 
                 prog_opt{prog_opt},
-                verbose{prog_opt.verbose},
+                verbose{prog_opt.verbose && ProcessRank() == 0},
                 triangle{model.mesh_params},
-                solver{model.solver_params, prog_opt.verbose}  
+                solver{model.solver_params, prog_opt.verbose},
+                writer{prog_opt.output_queue_size},
+                journal{prog_opt.journal_snapshot_period}
             {
                 if (model.region.empty())
                     model.InitializeLaplace();
 
                 for(auto& source_id: model.sources.GetSourcesIds())
                     model.rivers.at(source_id).AddPoint(Polar{0.1, 0}, model.river_boundary_id);
+
+                init_distributed_solver();
             };
 
             RiverSolver(const cxxopts::ParseResult po):
                 model{getModel(po)},
                 prog_opt{getProgramOptions(po)},
-                verbose{prog_opt.verbose},
+                verbose{prog_opt.verbose && ProcessRank() == 0},
                 triangle{model.mesh_params},
-                solver{model.solver_params, prog_opt.verbose}
+                solver{model.solver_params, prog_opt.verbose},
+                writer{prog_opt.output_queue_size},
+                journal{prog_opt.journal_snapshot_period}
             {
                 if (model.region.empty())
                     model.InitializeLaplace();
 
                 for(auto& source_id: model.sources.GetSourcesIds())
                     model.rivers.at(source_id).AddPoint(Polar{0.1, 0}, model.river_boundary_id);
+
+                init_distributed_solver();
             };
 
             int run();
@@ -109,8 +122,85 @@ namespace River
 
             Triangle triangle;
 
-            tethex::Mesh mesh;
+            tethex::FlatMesh mesh;
             
             Solver solver;
+
+#ifdef RIVERSIM_DISTRIBUTED_SOLVER
+            /*! \brief Used instead of solver, if program is run by several MPI processes(e.g. "mpirun -np 4 ./riversim").
+                \details Each process generates same boundary and mesh, and gets same series parameters from
+                River::DistributedSolver::integrate_tips(), so rivers grow equally on all processes.
+            */
+            unique_ptr<DistributedSolver> distributed_solver;
+#endif
+
+            ///Rank of MPI process, only root(zero) process prints messages and writes output files.
+            const unsigned process_rank = ProcessRank();
+
+            ///Wall time in seconds of series parameters integration of each tip at last step.
+            map<t_branch_id, double> tips_integration_time;
+
+            /*! \brief Time of simulation phases(boundary and mesh generation, solution, integration, saving etc.) and counters.
+                \details Triangle and Solver phases are timed by their own objects(River::Triangle::timers, River::Solver::timers).
+            */
+            Timers timers;
+
+            /*! \brief Appends time of phases and counters of current step of all modules to simulation data and resets them.
+                \details Keys are "Time/<phase>" and "Count/<counter>". It is called before step is saved, so time of saving
+                is recorded at next step.
+            */
+            void record_step_timers();
+
+            /*! \brief Writes output files(JSON state, VTK solution) in background while next steps are simulated.
+                \details Size of its queue is River::ProgramOptions::output_queue_size. Files are written before run() returns.
+            */
+            AsyncWriter writer;
+
+            ///Saves copy of current model by writer, same as River::Save.
+            void save_model(const string file_name);
+
+            ///Steps of simulation, written if River::ProgramOptions::journal_snapshot_period isn't zero.
+            Journal journal;
+
+            /*! \brief Saves state after step.
+                \details Without journal whole model is saved by save_model(). With journal record of step is appended to
+                "<output>.journal", and whole model is saved only with full records of journal, at each step if save_each_step is set,
+                and at the end of run().
+            */
+            void save_step(const string file_name);
+
+        private:
+            ///Number of steps recorded by record_step_timers().
+            unsigned n_timed_steps = 0;
+
+            ///Creates distributed_solver if program is run by several MPI processes.
+            void init_distributed_solver();
+
+            ///Timers of all modules.
+            vector<Timers*> modules_timers();
+
+            ///Saves number of cells, degrees of freedom and solver iterations of step to simulation data.
+            void record_solver_data();
+#ifdef RIVERSIM_DISTRIBUTED_SOLVER
+            ///Same as solve_and_evaluate_series_parameters() after mesh generation, but with distributed_solver.
+            t_ids_series_params distributed_solve_and_evaluate_series_parameters(const string &output_file_name);
+#endif
     };
+
+    /*! \brief Runs independent simulations of ensemble file(program option --ensemble) in one process.
+        \details Ensemble file is JSON object with array "runs". Each run starts from model and program options
+        of command line, then opens its "input" file, if it is set, and applies its partial "model" and "program_options"
+        objects, which have same structure as in output JSON(see River::Save). Top level "model" object is applied
+        to all runs before their own one.
+
+        Each run has its own River::RiverSolver and is a task of Deal.II work stealing scheduler(TBB), so tasks of
+        runs and their inner tasks(assembly, integration of tips) share one thread pool. Optional top level "threads"
+        limits number of threads of whole ensemble(command line option --threads is used if it isn't set). It is the only
+        thread limit, which applies: "num_of_threads" of runs solver parameters is ignored. Runs are silent unless "verbose" is set in their program options.
+
+        Run is saved to its "output", by default "<output>_<index of run>", and summary of all runs(return code,
+        wall time, number of tips and total time of phases) is saved to "<output>_ensemble.json".
+        \return 0 if all runs succeeded, 1 otherwise.
+    */
+    int RunEnsemble(const cxxopts::ParseResult &po);
 }
\ No newline at end of file
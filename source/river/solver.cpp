@@ -16,6 +16,7 @@
 #include <deal.II/grid/grid_tools.h>
 #include <string>
 #include <numeric>
+#include <limits>
 
 namespace River
 {
@@ -25,12 +26,148 @@ namespace River
         write << "\t weigth_func_radius = " << ip.weigth_func_radius << endl;
         write << "\t integration_radius = " << ip.integration_radius << endl;
         write << "\t exponant = " << ip.exponant << endl;
+        write << "\t integration_method = " << ip.integration_method << endl;
+        write << "\t spectral_eps = " << ip.spectral_eps << endl;
+        write << "\t spectral_max_levels = " << ip.spectral_max_levels << endl;
         return write;
     }
 
     bool IntegrationParams::operator==(const IntegrationParams &ip) const
     {
-        return abs(weigth_func_radius - ip.weigth_func_radius) < EPS && abs(integration_radius - ip.integration_radius) < EPS && abs(exponant - ip.exponant) < EPS;
+        return abs(weigth_func_radius - ip.weigth_func_radius) < EPS && abs(integration_radius - ip.integration_radius) < EPS && abs(exponant - ip.exponant) < EPS && integration_method == ip.integration_method && abs(spectral_eps - ip.spectral_eps) < EPS && spectral_max_levels == ip.spectral_max_levels;
+    }
+
+    // IntegrationStencil
+    IntegrationStencil::IntegrationStencil(const IntegrationParams &integ):
+        integ{integ}
+    {
+        auto drho = integ.integration_radius / 8; // 8 higher value gives better results
+        for (double rho = drho; rho < integ.integration_radius; rho += drho)
+        {
+            auto weight_func_value = integ.WeightFunction(rho);
+            for (double phi = 0; phi < 2 * M_PI; phi += M_PI / 4200 /*4200*/ / rho * integ.integration_radius)
+            {
+                // in tip frame base vector doesn't depend on tip angle
+                const auto 
+                    x = rho * cos(phi),
+                    y = rho * sin(phi);
+                dx.push_back(x);
+                dy.push_back(y);
+
+                // cycle over all series parameters order
+                for (unsigned param_index = 0; param_index < 3; ++param_index)
+                {
+                    auto base_vector_value = integ.BaseVectorFinal(param_index + 1, 0, x, y);
+                    weighted_base[param_index].push_back(weight_func_value * base_vector_value * rho);
+                    weighted_base_squared[param_index].push_back(weight_func_value * pow(base_vector_value, 2) * rho);
+                    normalization_integral[param_index] += weighted_base_squared[param_index].back();
+                }
+            }
+        }
+    }
+
+    IntegrationStencil::IntegrationStencil(const IntegrationParams &integ, const unsigned level):
+        integ{integ}
+    {
+        // index pairs (i, j) of nodes in t and phi, nodes of previous level keep their order and get doubled indices
+        vector<pair<unsigned, unsigned>> nodes;
+        unsigned n_t = 0, n_phi = 0;
+        for (unsigned l = 0; l <= level; ++l)
+        {
+            n_t = 4 << l;
+            n_phi = 16 << l;
+            for (auto &node: nodes)
+            {
+                node.first *= 2;
+                node.second *= 2;
+            }
+            for (unsigned i = 1; i < n_t; ++i)
+                for (unsigned j = 1; j < n_phi; ++j)
+                    if (l == 0 || i % 2 || j % 2)
+                        nodes.emplace_back(i, j);
+        }
+
+        // Fejer second rule on [-1, 1] with n intervals, nodes cos(k * pi / n) exclude ends of interval
+        auto fejer_weights = [](const unsigned n)
+        {
+            vector<double> weights(n);
+            for (unsigned k = 1; k < n; ++k)
+            {
+                const auto theta = k * M_PI / n;
+                double sum = 0;
+                for (unsigned j = 1; j <= n / 2; ++j)
+                    sum += sin((2 * j - 1) * theta) / (2 * j - 1);
+                weights[k] = 4 * sin(theta) / n * sum;
+            }
+            return weights;
+        };
+        const auto t_weights = fejer_weights(n_t), phi_weights = fejer_weights(n_phi);
+
+        for (const auto [i, j]: nodes)
+        {
+            const auto 
+                t = (1 + cos(i * M_PI / n_t)) / 2,
+                rho = integ.integration_radius * t * t,
+                // drho = 2 * integration_radius * t * dt and dt = dx / 2
+                rho_weight = integ.integration_radius * t * t_weights[i],
+                phi = M_PI * cos(j * M_PI / n_phi),
+                phi_weight = M_PI * phi_weights[j],
+                weight_func_value = integ.WeightFunction(rho),
+                x = rho * cos(phi),
+                y = rho * sin(phi);
+            dx.push_back(x);
+            dy.push_back(y);
+
+            for (unsigned param_index = 0; param_index < 3; ++param_index)
+            {
+                auto base_vector_value = integ.BaseVectorFinal(param_index + 1, 0, x, y);
+                weighted_base[param_index].push_back(weight_func_value * base_vector_value * rho * rho_weight * phi_weight);
+                weighted_base_squared[param_index].push_back(weight_func_value * pow(base_vector_value, 2) * rho * rho_weight * phi_weight);
+                normalization_integral[param_index] += weighted_base_squared[param_index].back();
+            }
+        }
+    }
+
+    t_PointList IntegrationStencil::Points(const River::Point &tip_coord, const double angle, const size_t first) const
+    {
+        const auto c = cos(angle), s = sin(angle);
+
+        t_PointList points(size() - min(first, size()));
+        for (size_t k = 0; k < points.size(); ++k)
+        {
+            points[k].x = tip_coord.x + c * dx[first + k] - s * dy[first + k];
+            points[k].y = tip_coord.y + s * dx[first + k] + c * dy[first + k];
+        }
+        return points;
+    }
+
+    vector<double> IntegrationStencil::SeriesParameters(const vector<double> &sample_values, const vector<double> &mask) const
+    {
+        // values outside region are zero, so only normalization integral needs mask
+        const auto all_inside = all_of(mask.begin(), mask.end(), [](double m){return m > 0;});
+
+        vector<double> series_params(3, 0);
+        for (unsigned param_index = 0; param_index < series_params.size(); ++param_index)
+        {
+            const auto &weighted_base = this->weighted_base[param_index];
+            const auto &weighted_base_squared = this->weighted_base_squared[param_index];
+
+            double integral = 0;
+            for (size_t k = 0; k < sample_values.size(); ++k)
+                integral += sample_values[k] * weighted_base[k];
+
+            double normalization_integral = this->normalization_integral[param_index];
+            if (!all_inside)
+            {
+                normalization_integral = 0;
+                for (size_t k = 0; k < mask.size(); ++k)
+                    normalization_integral += mask[k] * weighted_base_squared[k];
+            }
+
+            series_params[param_index] = integral / normalization_integral;
+        }
+
+        return series_params;
     }
 
     // SolverParams
@@ -42,17 +179,25 @@ namespace River
         write << "\t adaptive_refinment_steps = " << sp.adaptive_refinment_steps << endl;
         write << "\t tollerance = " << sp.tollerance << endl;
         write << "\t number of iteration = " << sp.num_of_iterrations << endl;
+        write << "\t preconditioner_type = " << sp.preconditioner_type << endl;
+        write << "\t warm_start = " << sp.warm_start << endl;
+        write << "\t num_of_threads = " << sp.num_of_threads << endl;
+        write << "\t matrix_free = " << sp.matrix_free << endl;
+        write << "\t condensation_radius = " << sp.condensation_radius << endl;
+        write << "\t mixed_precision = " << sp.mixed_precision << endl;
+        write << "\t direct_solver = " << sp.direct_solver << endl;
         return write;
     }
 
     bool SolverParams::operator==(const SolverParams &sp) const
     {
-        return abs(field_value - sp.field_value) < EPS && abs(tollerance - sp.tollerance) < EPS && num_of_iterrations == sp.num_of_iterrations && adaptive_refinment_steps == sp.adaptive_refinment_steps && abs(refinment_fraction - sp.refinment_fraction) < EPS && quadrature_degree == sp.quadrature_degree && renumbering_type == sp.renumbering_type && abs(max_distance - sp.max_distance) < EPS;
+        return abs(field_value - sp.field_value) < EPS && abs(tollerance - sp.tollerance) < EPS && num_of_iterrations == sp.num_of_iterrations && adaptive_refinment_steps == sp.adaptive_refinment_steps && abs(refinment_fraction - sp.refinment_fraction) < EPS && quadrature_degree == sp.quadrature_degree && renumbering_type == sp.renumbering_type && preconditioner_type == sp.preconditioner_type && warm_start == sp.warm_start && num_of_threads == sp.num_of_threads && matrix_free == sp.matrix_free && abs(condensation_radius - sp.condensation_radius) < EPS && mixed_precision == sp.mixed_precision && direct_solver == sp.direct_solver && abs(max_distance - sp.max_distance) < EPS;
     }
 
     // Solver
     void Solver::OpenMesh(const string fileName)
     {
+        auto timer = timers.scope("OpenMesh/CreateTriangulation");
         GridIn<dim> gridin;
         gridin.attach_triangulation(triangulation);
         ifstream f(fileName);
@@ -63,6 +208,7 @@ namespace River
 
     void Solver::OpenMesh(const tethex::Mesh &mesh)
     {
+        auto timer = timers.scope("OpenMesh/CreateTriangulation");
         auto n = mesh.get_vertices().size();
 
         //vertices conversion
@@ -101,6 +247,70 @@ namespace River
         triangulation.create_triangulation(vertices, cells, subcelldata);
     }
 
+    void Solver::OpenMesh(const tethex::FlatMesh &mesh)
+    {
+        auto timer = timers.scope("OpenMesh/CreateTriangulation");
+        std::vector<dealii::Point<dim>> vertices(mesh.get_n_vertices());
+        for(size_t i = 0; i < vertices.size(); ++i)
+            vertices[i] = dealii::Point<dim>(mesh.vertices[2 * i], mesh.vertices[2 * i + 1]);
+
+        std::vector<CellData<dim>> cells(mesh.get_n_quadrangles());
+        for(size_t i = 0; i < cells.size(); ++i)
+        {
+            for(unsigned k = 0; k < GeometryInfo<dim>::vertices_per_cell; ++k)
+                cells[i].vertices[k] = mesh.quadrangles[4 * i + k];
+            cells[i].material_id = mesh.quadrangle_material_ids[i];
+            cells[i].manifold_id = static_cast<types::manifold_id>(101);
+        }
+
+        SubCellData subcelldata;
+        subcelldata.boundary_lines.resize(mesh.get_n_lines());
+        for(size_t i = 0; i < subcelldata.boundary_lines.size(); ++i)
+        {
+            subcelldata.boundary_lines[i].vertices[0] = mesh.lines[2 * i];
+            subcelldata.boundary_lines[i].vertices[1] = mesh.lines[2 * i + 1];
+            subcelldata.boundary_lines[i].material_id = mesh.line_material_ids[i];
+        }
+
+        triangulation.create_triangulation(vertices, cells, subcelldata);
+    }
+
+    bool Solver::OpenMeshIfChanged(const tethex::FlatMesh &mesh, unsigned int num_of_static_refinments, const double integration_radius, const t_PointList &tips_points)
+    {
+        // static refinment depends on tips and radius, so they are hashed together with mesh
+        auto fingerprint = mesh.fingerprint();
+        auto add = [&fingerprint](const double value)
+        {
+            fingerprint = (fingerprint ^ hash<double>{}(value)) * 1099511628211ull;
+        };
+        add(num_of_static_refinments);
+        add(integration_radius);
+        for (const auto &tip : tips_points)
+        {
+            add(tip.x);
+            add(tip.y);
+        }
+        // zero fingerprint means that nothing is cached
+        if (fingerprint == 0)
+            fingerprint = 1;
+
+        is_system_reused = fingerprint == mesh_fingerprint && dof_handler.n_dofs() > 0;
+        if (is_system_reused)
+        {
+            timers.count("ReusedSystems");
+            return true;
+        }
+
+        if (warm_start)
+            save_previous_solution();
+        clear();
+        OpenMesh(mesh);
+        static_refine_grid(num_of_static_refinments, integration_radius, tips_points);
+        mesh_fingerprint = fingerprint;
+
+        return false;
+    }
+
     void Solver::setBoundaryConditions(const BoundaryConditions &boundary_conds)
     {
         boundary_conditions = boundary_conds;
@@ -108,6 +318,7 @@ namespace River
 
     void Solver::setup_system()
     {
+        auto timer = timers.scope("Solve/Setup");
         dof_handler.distribute_dofs(fe);
         DoFRenumbering::Cuthill_McKee(dof_handler);
 
@@ -117,88 +328,212 @@ namespace River
 
         hanging_node_constraints.close();
 
+        laplace_matrix.clear();
+        is_laplace_matrix_assembled = false;
+        if (!matrix_free && !is_condensation_used())
+            make_sparsity_pattern();
+        else
+        {
+            // whole pattern is built by assemble_system() only if solve_condensed() falls back to whole system
+            system_matrix.clear();
+            sparsity_pattern.reinit(0, 0, 0);
+        }
+        clear_multigrid();
+
+        solution.reinit(dof_handler.n_dofs());
+        system_rhs.reinit(dof_handler.n_dofs());
+
+        build_cell_buckets();
+    }
+
+    void Solver::make_sparsity_pattern()
+    {
         DynamicSparsityPattern dsp(dof_handler.n_dofs(), dof_handler.n_dofs());
         DoFTools::make_sparsity_pattern(
             dof_handler,
             dsp);
         hanging_node_constraints.condense(dsp);
 
+        system_matrix.clear();
         sparsity_pattern.copy_from(dsp);
         system_matrix.reinit(sparsity_pattern);
-
-        solution.reinit(dof_handler.n_dofs());
-        system_rhs.reinit(dof_handler.n_dofs());
     }
 
-    void Solver::assemble_system(const BoundaryConditions &boundary_conditions)
+    void Solver::save_previous_solution()
     {
-        const unsigned n_q_points = quadrature_formula.size();
-        const unsigned n_face_q_points = face_quadrature_formula.size();
+        auto timer = timers.scope("OpenMesh/SavePreviousSolution");
+        previous_dof_handler.clear();
+        previous_triangulation.clear();
+        previous_solution.reinit(0);
 
-        const unsigned dofs_per_cell = fe.dofs_per_cell;
+        if (!solved() || solution.size() != dof_handler.n_dofs())
+            return;
 
-        FullMatrix<double> cell_matrix(dofs_per_cell, dofs_per_cell);
-        Vector<double> cell_rhs(dofs_per_cell);
+        previous_triangulation.copy_triangulation(triangulation);
 
-        vector<types::global_dof_index> local_dof_indices(dofs_per_cell);
+        // same distribution and renumbering as in setup_system, so dof indices of solution stay valid
+        previous_dof_handler.distribute_dofs(fe);
+        DoFRenumbering::Cuthill_McKee(previous_dof_handler);
+
+        previous_solution = solution;
+    }
 
-        FEValues<dim> fe_values(fe,
-                                quadrature_formula,
-                                update_values | update_gradients | update_quadrature_points | update_JxW_values);
+    void Solver::interpolate_previous_solution()
+    {
+        if (previous_solution.size() == 0)
+            return;
 
-        FEFaceValues<dim> fe_face_values(fe,
-                                         face_quadrature_formula,
-                                         update_values | update_quadrature_points | update_JxW_values);
+        auto timer = timers.scope("Solve/WarmStart");
 
-        for (const auto &cell : dof_handler.active_cell_iterators())
+        vector<dealii::Point<dim>> support_points(dof_handler.n_dofs());
+        DoFTools::map_dofs_to_support_points(MappingQ1<dim>(), dof_handler, support_points);
+
+        Functions::FEFieldFunction<dim> previous_field(previous_dof_handler, previous_solution);
+        for (types::global_dof_index i = 0; i < support_points.size(); ++i)
         {
-            cell_matrix = 0.;
-            cell_rhs = 0.;
+            try
+            {
+                solution(i) = previous_field.value(support_points[i]);
+            }
+            catch (const VectorTools::ExcPointNotAvailableHere &error)
+            {
+                // point is outside of previous region(e.g. near tips), so zero guess is used
+                solution(i) = 0;
+            }
+        }
+    }
 
-            fe_values.reinit(cell);
+    Solver::AssemblyScratchData::AssemblyScratchData(
+        const FiniteElement<dim> &fe,
+        const dealii::Quadrature<dim> &quadrature,
+        const dealii::Quadrature<dim - 1> &face_quadrature):
+        fe_values(fe, quadrature,
+            update_values | update_gradients | update_quadrature_points | update_JxW_values),
+        fe_face_values(fe, face_quadrature,
+            update_values | update_quadrature_points | update_JxW_values)
+    {}
+
+    Solver::AssemblyScratchData::AssemblyScratchData(const AssemblyScratchData &scratch_data):
+        fe_values(scratch_data.fe_values.get_fe(),
+            scratch_data.fe_values.get_quadrature(),
+            scratch_data.fe_values.get_update_flags()),
+        fe_face_values(scratch_data.fe_face_values.get_fe(),
+            scratch_data.fe_face_values.get_quadrature(),
+            scratch_data.fe_face_values.get_update_flags())
+    {}
+
+    void Solver::local_assemble_system(
+        const typename DoFHandler<dim>::active_cell_iterator &cell,
+        const t_BoundaryConditions &neuman_bd,
+        const bool assemble_matrix,
+        AssemblyScratchData &scratch_data,
+        AssemblyCopyData &copy_data) const
+    {
+        auto &fe_values = scratch_data.fe_values;
+        auto &fe_face_values = scratch_data.fe_face_values;
 
-            for (unsigned q_index = 0; q_index < n_q_points; ++q_index)
-                for (unsigned i = 0; i < dofs_per_cell; ++i)
-                {
+        const unsigned n_q_points = fe_values.get_quadrature().size();
+        const unsigned n_face_q_points = fe_face_values.get_quadrature().size();
+
+        const unsigned dofs_per_cell = fe.dofs_per_cell;
+
+        copy_data.assemble_matrix = assemble_matrix;
+        if (assemble_matrix)
+            copy_data.cell_matrix.reinit(dofs_per_cell, dofs_per_cell);
+        copy_data.cell_rhs.reinit(dofs_per_cell);
+        copy_data.local_dof_indices.resize(dofs_per_cell);
+
+        auto &cell_matrix = copy_data.cell_matrix;
+        auto &cell_rhs = copy_data.cell_rhs;
+
+        fe_values.reinit(cell);
+
+        for (unsigned q_index = 0; q_index < n_q_points; ++q_index)
+            for (unsigned i = 0; i < dofs_per_cell; ++i)
+            {
+                if (assemble_matrix)
                     for (unsigned int j = 0; j < dofs_per_cell; ++j)
                         cell_matrix(i, j) += fe_values.shape_grad(i, q_index) *
                                              fe_values.shape_grad(j, q_index) *
                                              fe_values.JxW(q_index);
 
-                    cell_rhs(i) += field_value *
-                                   fe_values.shape_value(i, q_index) *
-                                   fe_values.JxW(q_index);
-                }
+                cell_rhs(i) += field_value *
+                               fe_values.shape_value(i, q_index) *
+                               fe_values.JxW(q_index);
+            }
 
-            auto neuman_bd = boundary_conditions.Get(NEUMAN);
-            for (unsigned int face_number = 0; face_number < GeometryInfo<dim>::faces_per_cell; ++face_number)
-                if (cell->face(face_number)->at_boundary() &&
-                    neuman_bd.count(cell->face(face_number)->boundary_id()))
-                {
-                    fe_face_values.reinit(cell, face_number);
-                    auto boundary_id = cell->face(face_number)->boundary_id();
-                    const auto neuman_value = neuman_bd.at(boundary_id).value;
-                    for (unsigned int q_point = 0; q_point < n_face_q_points; ++q_point)
-                        for (unsigned int i = 0; i < dofs_per_cell; ++i)
-                            cell_rhs(i) += neuman_value *
-                                           fe_face_values.shape_value(i, q_point) *
-                                           fe_face_values.JxW(q_point);
-                }
+        for (unsigned int face_number = 0; face_number < GeometryInfo<dim>::faces_per_cell; ++face_number)
+            if (cell->face(face_number)->at_boundary() &&
+                neuman_bd.count(cell->face(face_number)->boundary_id()))
+            {
+                fe_face_values.reinit(cell, face_number);
+                auto boundary_id = cell->face(face_number)->boundary_id();
+                const auto neuman_value = neuman_bd.at(boundary_id).value;
+                for (unsigned int q_point = 0; q_point < n_face_q_points; ++q_point)
+                    for (unsigned int i = 0; i < dofs_per_cell; ++i)
+                        cell_rhs(i) += neuman_value *
+                                       fe_face_values.shape_value(i, q_point) *
+                                       fe_face_values.JxW(q_point);
+            }
+
+        cell->get_dof_indices(copy_data.local_dof_indices);
+    }
 
-            cell->get_dof_indices(local_dof_indices);
-            for (unsigned int i = 0; i < dofs_per_cell; ++i)
+    void Solver::copy_local_to_global(const AssemblyCopyData &copy_data)
+    {
+        if (copy_data.assemble_matrix)
+            system_matrix.add(copy_data.local_dof_indices, copy_data.cell_matrix);
+        system_rhs.add(copy_data.local_dof_indices, copy_data.cell_rhs);
+    }
+
+    void Solver::assemble_system(const BoundaryConditions &boundary_conditions)
+    {
+        auto timer = timers.scope("Solve/Assembly");
+        const auto neuman_bd = boundary_conditions.Get(NEUMAN);
+
+        // system matrix can be skipped by setup_system() or hold zone pattern of solve_condensed()
+        if (system_matrix.empty() || &system_matrix.get_sparsity_pattern() != &sparsity_pattern)
+        {
+            if (sparsity_pattern.n_rows() != dof_handler.n_dofs())
+                make_sparsity_pattern();
+            else
+                system_matrix.reinit(sparsity_pattern);
+        }
+
+        // stiffness matrix depends only on triangulation, so while it is unchanged only right hand side is assembled
+        const bool assemble_matrix = !is_laplace_matrix_assembled;
+
+        // each worker thread fills local cell matrices, and copier adds them to global system sequentially
+        WorkStream::run(
+            dof_handler.begin_active(),
+            dof_handler.end(),
+            [this, &neuman_bd, assemble_matrix](const typename DoFHandler<dim>::active_cell_iterator &cell,
+                AssemblyScratchData &scratch_data,
+                AssemblyCopyData &copy_data)
+            {
+                local_assemble_system(cell, neuman_bd, assemble_matrix, scratch_data, copy_data);
+            },
+            [this](const AssemblyCopyData &copy_data)
             {
-                for (unsigned int j = 0; j < dofs_per_cell; ++j)
-                    system_matrix.add(
-                        local_dof_indices[i],
-                        local_dof_indices[j],
-                        cell_matrix(i, j));
+                copy_local_to_global(copy_data);
+            },
+            AssemblyScratchData(fe, quadrature_formula, face_quadrature_formula),
+            AssemblyCopyData());
 
-                system_rhs(local_dof_indices[i]) += cell_rhs(i);
+        if (assemble_matrix)
+        {
+            hanging_node_constraints.condense(system_matrix);
+
+            // boundary values are applied to copy, so matrix can be used at next run with same triangulation
+            if (mesh_fingerprint && num_of_adaptive_refinments == 0)
+            {
+                laplace_matrix.reinit(sparsity_pattern);
+                laplace_matrix.copy_from(system_matrix);
+                is_laplace_matrix_assembled = true;
             }
         }
-
-        hanging_node_constraints.condense(system_matrix);
+        else
+            system_matrix.copy_from(laplace_matrix);
         hanging_node_constraints.condense(system_rhs);
 
         std::map<types::global_dof_index, double> boundary_values;
@@ -219,21 +554,810 @@ namespace River
 
     void Solver::solve()
     {
+        if (direct_solver)
+        {
+            solve_direct();
+            return;
+        }
+
+        if (mixed_precision && solve_mixed_precision())
+        {
+            hanging_node_constraints.distribute(solution);
+            return;
+        }
+
+        auto timer = timers.scope("Solve/CG");
         SolverControl solver_control(number_of_iterations, tollerance);
         SolverCG<> cg(solver_control);
 
-        PreconditionSSOR<> preconditioner;
-        preconditioner.initialize(system_matrix, 1.2);
+        if (preconditioner_type == 0)
+        {
+            PreconditionSSOR<> preconditioner;
+            preconditioner.initialize(system_matrix, 1.2);
+            cg.solve(system_matrix, solution, system_rhs, preconditioner);
+        }
+        else if (preconditioner_type == 1)
+        {
+            PreconditionJacobi<> preconditioner;
+            preconditioner.initialize(system_matrix);
+            cg.solve(system_matrix, solution, system_rhs, preconditioner);
+        }
+        else if (preconditioner_type == 2)
+        {
+#ifdef DEAL_II_WITH_TRILINOS
+            TrilinosWrappers::PreconditionAMG::AdditionalData amg_data;
+            amg_data.elliptic = true;
+            amg_data.higher_order_elements = fe.degree > 1;
+            amg_data.smoother_sweeps = 2;
+            amg_data.aggregation_threshold = 0.02;
+
+            TrilinosWrappers::PreconditionAMG preconditioner;
+            preconditioner.initialize(system_matrix, amg_data);
+            cg.solve(system_matrix, solution, system_rhs, preconditioner);
+#else
+            throw Exception("solve: algebraic multigrid preconditioner needs Deal.II built with Trilinos.");
+#endif
+        }
+        else if (preconditioner_type == 3)
+            throw Exception("solve: geometric multigrid needs level matrices, system should be solved by solve_multigrid().");
+        else
+            throw Exception("solve: unknown preconditioner type: " + to_string(preconditioner_type));
 
-        cg.solve(
-            system_matrix,
-            solution,
-            system_rhs,
-            preconditioner);
+        number_of_solver_iterations += solver_control.last_step();
 
         hanging_node_constraints.distribute(solution);
+    }
 
-        
+    void Solver::solve_direct()
+    {
+#ifdef DEAL_II_WITH_UMFPACK
+        // FNV hash of pattern and values, like tethex::FlatMesh::fingerprint()
+        uint64_t fingerprint = 14695981039346656037ull;
+        auto add = [&fingerprint](const size_t value)
+        {
+            fingerprint = (fingerprint ^ value) * 1099511628211ull;
+        };
+        add(system_matrix.m());
+        for (auto entry = system_matrix.begin(); entry != system_matrix.end(); ++entry)
+        {
+            add(entry->column());
+            add(hash<double>{}(entry->value()));
+        }
+        // zero fingerprint means that there is no factorization
+        if (fingerprint == 0)
+            fingerprint = 1;
+
+        if (fingerprint != factorization_fingerprint)
+        {
+            auto timer = timers.scope("Solve/Factorization");
+            direct_factorization.initialize(system_matrix);
+            factorization_fingerprint = fingerprint;
+            timers.count("Factorizations");
+        }
+        else
+            timers.count("ReusedFactorizations");
+
+        auto timer = timers.scope("Solve/Direct");
+        direct_factorization.vmult(solution, system_rhs);
+
+        hanging_node_constraints.distribute(solution);
+#else
+        throw Exception("solve_direct: direct solver needs Deal.II built with UMFPACK.");
+#endif
+    }
+
+    bool Solver::solve_mixed_precision()
+    {
+        if (preconditioner_type > 1)
+            return false;
+
+        auto timer = timers.scope("Solve/MixedPrecisionCG");
+        system_matrix_float.clear();
+        system_matrix_float.reinit(system_matrix.get_sparsity_pattern());
+        system_matrix_float.copy_from(system_matrix);
+
+        PreconditionSSOR<SparseMatrix<float>> ssor;
+        PreconditionJacobi<SparseMatrix<float>> jacobi;
+        if (preconditioner_type == 0)
+            ssor.initialize(system_matrix_float, 1.2);
+        else
+            jacobi.initialize(system_matrix_float);
+
+        Vector<double> residual(solution.size()), correction(solution.size());
+        Vector<float> residual_float(solution.size()), correction_float(solution.size());
+        auto residual_norm = system_matrix.residual(residual, solution, system_rhs);
+        auto previous_residual_norm = numeric_limits<double>::max();
+        // number_of_solver_iterations is accumulated over adaptive cycles, so only iterations of this call are capped
+        unsigned inner_iterations = 0;
+        while (residual_norm > tollerance)
+        {
+            // single precision correction doesn't improve solution any more
+            if (residual_norm > 0.5 * previous_residual_norm || inner_iterations >= number_of_iterations)
+                return false;
+            previous_residual_norm = residual_norm;
+
+            residual_float = residual;
+            correction_float = 0;
+            ReductionControl solver_control(number_of_iterations - inner_iterations, tollerance, 1e-4, false, false);
+            SolverCG<Vector<float>> cg(solver_control);
+            try
+            {
+                if (preconditioner_type == 0)
+                    cg.solve(system_matrix_float, correction_float, residual_float, ssor);
+                else
+                    cg.solve(system_matrix_float, correction_float, residual_float, jacobi);
+            }
+            catch (const SolverControl::NoConvergence &error)
+            {
+                number_of_solver_iterations += solver_control.last_step();
+                return false;
+            }
+            inner_iterations += solver_control.last_step();
+            number_of_solver_iterations += solver_control.last_step();
+            timers.count("MixedPrecisionCorrections");
+
+            correction = correction_float;
+            solution += correction;
+            residual_norm = system_matrix.residual(residual, solution, system_rhs);
+        }
+
+        return true;
+    }
+
+    template <int fe_degree>
+    void Solver::solve_matrix_free_degree()
+    {
+        typedef LinearAlgebra::distributed::Vector<double> VectorType;
+        typedef MatrixFreeOperators::LaplaceOperator<dim, fe_degree, fe_degree + 1, 1, VectorType> OperatorType;
+
+        // hanging nodes and homogeneous Dirichlet constraints, real Dirichlet values are lifted into rhs
+        AffineConstraints<double> constraints;
+        DoFTools::make_hanging_node_constraints(dof_handler, constraints);
+        std::map<types::global_dof_index, double> boundary_values;
+        for (const auto &[boundary_id, boundary_condition] : boundary_conditions.Get(DIRICHLET))
+        {
+            VectorTools::interpolate_boundary_values(
+                dof_handler,
+                boundary_id,
+                Functions::ZeroFunction<dim>(),
+                constraints);
+            VectorTools::interpolate_boundary_values(
+                dof_handler,
+                boundary_id,
+                Functions::ConstantFunction<dim>(boundary_condition.value),
+                boundary_values);
+        }
+        constraints.close();
+
+        const MappingQ1<dim> mapping;
+        typename MatrixFree<dim, double>::AdditionalData additional_data;
+        additional_data.tasks_parallel_scheme = MatrixFree<dim, double>::AdditionalData::partition_color;
+        additional_data.mapping_update_flags = update_values | update_gradients | update_JxW_values;
+        additional_data.mapping_update_flags_boundary_faces = update_values | update_JxW_values;
+
+        auto matrix_free_data = std::make_shared<MatrixFree<dim, double>>();
+        matrix_free_data->reinit(mapping, dof_handler, constraints, QGauss<1>(fe_degree + 1), additional_data);
+
+        OperatorType system_operator;
+        system_operator.initialize(matrix_free_data);
+        system_operator.compute_diagonal();
+
+        VectorType lifting, rhs, u;
+        matrix_free_data->initialize_dof_vector(lifting);
+        matrix_free_data->initialize_dof_vector(rhs);
+        matrix_free_data->initialize_dof_vector(u);
+
+        for (const auto &[dof, value] : boundary_values)
+            lifting(dof) = value;
+        hanging_node_constraints.distribute(lifting);
+
+        // volume part of rhs: f*v - grad(lifting)*grad(v)
+        FEEvaluation<dim, fe_degree> phi(*matrix_free_data);
+        for (unsigned cell = 0; cell < matrix_free_data->n_macro_cells(); ++cell)
+        {
+            phi.reinit(cell);
+            phi.read_dof_values_plain(lifting);
+            phi.evaluate(false, true);
+            for (unsigned q = 0; q < phi.n_q_points; ++q)
+            {
+                phi.submit_gradient(-phi.get_gradient(q), q);
+                phi.submit_value(make_vectorized_array<double>(field_value), q);
+            }
+            phi.integrate(true, true);
+            phi.distribute_local_to_global(rhs);
+        }
+
+        // Neuman part of rhs
+        const auto neuman_bd = boundary_conditions.Get(NEUMAN);
+        FEFaceEvaluation<dim, fe_degree> phi_face(*matrix_free_data, true);
+        const auto n_inner_faces = matrix_free_data->n_inner_face_batches();
+        for (unsigned face = n_inner_faces; face < n_inner_faces + matrix_free_data->n_boundary_face_batches(); ++face)
+        {
+            const auto boundary_id = matrix_free_data->get_boundary_id(face);
+            if (!neuman_bd.count(boundary_id))
+                continue;
+
+            phi_face.reinit(face);
+            const auto neuman_value = make_vectorized_array<double>(neuman_bd.at(boundary_id).value);
+            for (unsigned q = 0; q < phi_face.n_q_points; ++q)
+                phi_face.submit_value(neuman_value, q);
+            phi_face.integrate(true, false);
+            phi_face.distribute_local_to_global(rhs);
+        }
+        rhs.compress(VectorOperation::add);
+
+        // initial guess, which is non zero only with warm start
+        for (types::global_dof_index i = 0; i < solution.size(); ++i)
+            u(i) = solution(i) - lifting(i);
+        constraints.set_zero(u);
+
+        SolverControl solver_control(number_of_iterations, tollerance);
+        SolverCG<VectorType> cg(solver_control);
+
+        PreconditionJacobi<OperatorType> preconditioner;
+        preconditioner.initialize(system_operator);
+
+        cg.solve(system_operator, u, rhs, preconditioner);
+
+        number_of_solver_iterations += solver_control.last_step();
+
+        constraints.distribute(u);
+        u += lifting;
+
+        for (types::global_dof_index i = 0; i < solution.size(); ++i)
+            solution(i) = u(i);
+    }
+
+    void Solver::solve_matrix_free()
+    {
+        auto timer = timers.scope("Solve/MatrixFree");
+        switch (fe.degree)
+        {
+            case 1: solve_matrix_free_degree<1>(); break;
+            case 2: solve_matrix_free_degree<2>(); break;
+            case 3: solve_matrix_free_degree<3>(); break;
+            case 4: solve_matrix_free_degree<4>(); break;
+            default:
+                throw Exception("solve_matrix_free: unsupported FE degree(quadrature_degree): " + to_string(fe.degree));
+        }
+    }
+
+    void Solver::setup_multigrid(const set<types::boundary_id> &dirichlet_boundary_ids)
+    {
+        auto timer = timers.scope("Solve/MultigridSetup");
+        dof_handler.distribute_mg_dofs();
+
+        mg_constrained_dofs.clear();
+        mg_constrained_dofs.initialize(dof_handler);
+        mg_constrained_dofs.make_zero_boundary_constraints(dof_handler, dirichlet_boundary_ids);
+        mg_dirichlet_boundary_ids = dirichlet_boundary_ids;
+
+        // matrices are resized before their sparsity patterns, which they refer to
+        const unsigned n_levels = triangulation.n_levels();
+        mg_interface_matrices.resize(0, n_levels - 1);
+        mg_matrices.resize(0, n_levels - 1);
+        mg_sparsity_patterns.resize(0, n_levels - 1);
+        mg_interface_sparsity_patterns.resize(0, n_levels - 1);
+        for (unsigned level = 0; level < n_levels; ++level)
+        {
+            DynamicSparsityPattern dsp(dof_handler.n_dofs(level), dof_handler.n_dofs(level));
+            MGTools::make_sparsity_pattern(dof_handler, dsp, level);
+            mg_sparsity_patterns[level].copy_from(dsp);
+            mg_matrices[level].reinit(mg_sparsity_patterns[level]);
+
+            DynamicSparsityPattern interface_dsp(dof_handler.n_dofs(level), dof_handler.n_dofs(level));
+            MGTools::make_interface_sparsity_pattern(dof_handler, mg_constrained_dofs, interface_dsp, level);
+            mg_interface_sparsity_patterns[level].copy_from(interface_dsp);
+            mg_interface_matrices[level].reinit(mg_interface_sparsity_patterns[level]);
+        }
+
+        mg_transfer.initialize_constraints(mg_constrained_dofs);
+        mg_transfer.build(dof_handler);
+
+        assemble_multigrid();
+        is_multigrid_ready = true;
+    }
+
+    void Solver::assemble_multigrid()
+    {
+        FEValues<dim> fe_values(fe, quadrature_formula, update_gradients | update_JxW_values);
+        const unsigned n_q_points = quadrature_formula.size();
+        const unsigned dofs_per_cell = fe.dofs_per_cell;
+
+        FullMatrix<double> cell_matrix(dofs_per_cell, dofs_per_cell);
+        vector<types::global_dof_index> local_dof_indices(dofs_per_cell);
+
+        // level dofs on refinment edges and Dirichlet boundaries are zero
+        vector<AffineConstraints<double>> boundary_constraints(triangulation.n_levels());
+        for (unsigned level = 0; level < triangulation.n_levels(); ++level)
+        {
+            IndexSet dofset;
+            DoFTools::extract_locally_relevant_level_dofs(dof_handler, level, dofset);
+            boundary_constraints[level].reinit(dofset);
+            boundary_constraints[level].add_lines(mg_constrained_dofs.get_refinement_edge_indices(level));
+            boundary_constraints[level].add_lines(mg_constrained_dofs.get_boundary_indices(level));
+            boundary_constraints[level].close();
+        }
+
+        for (const auto &cell : dof_handler.mg_cell_iterators())
+        {
+            cell_matrix = 0;
+            fe_values.reinit(cell);
+
+            for (unsigned q_index = 0; q_index < n_q_points; ++q_index)
+                for (unsigned i = 0; i < dofs_per_cell; ++i)
+                    for (unsigned j = 0; j < dofs_per_cell; ++j)
+                        cell_matrix(i, j) += fe_values.shape_grad(i, q_index) *
+                                             fe_values.shape_grad(j, q_index) *
+                                             fe_values.JxW(q_index);
+
+            const unsigned level = cell->level();
+            cell->get_mg_dof_indices(local_dof_indices);
+            boundary_constraints[level].distribute_local_to_global(cell_matrix, local_dof_indices, mg_matrices[level]);
+
+            for (unsigned i = 0; i < dofs_per_cell; ++i)
+                for (unsigned j = 0; j < dofs_per_cell; ++j)
+                    if (mg_constrained_dofs.is_interface_matrix_entry(level, local_dof_indices[i], local_dof_indices[j]))
+                        mg_interface_matrices[level].add(local_dof_indices[i], local_dof_indices[j], cell_matrix(i, j));
+        }
+    }
+
+    void Solver::solve_multigrid()
+    {
+        // smoothing can be set only by constructor, so it is missing if preconditioner type is changed later
+        if (!(triangulation.get_mesh_smoothing() & Triangulation<dim>::limit_level_difference_at_vertices))
+            throw Exception("solve_multigrid: triangulation doesn't limit level difference at vertices, "
+                "Solver should be constructed with preconditioner type 3 instead of changing it later.");
+
+        // hanging nodes and Dirichlet values are eliminated while cell contributions are added
+        AffineConstraints<double> constraints;
+        DoFTools::make_hanging_node_constraints(dof_handler, constraints);
+        set<types::boundary_id> dirichlet_boundary_ids;
+        for (const auto &[boundary_id, boundary_condition] : boundary_conditions.Get(DIRICHLET))
+        {
+            VectorTools::interpolate_boundary_values(
+                dof_handler,
+                boundary_id,
+                Functions::ConstantFunction<dim>(boundary_condition.value),
+                constraints);
+            dirichlet_boundary_ids.insert(boundary_id);
+        }
+        constraints.close();
+
+        if (!is_multigrid_ready || dirichlet_boundary_ids != mg_dirichlet_boundary_ids)
+            setup_multigrid(dirichlet_boundary_ids);
+
+        {
+            auto timer = timers.scope("Solve/Assembly");
+            const auto neuman_bd = boundary_conditions.Get(NEUMAN);
+            system_matrix = 0;
+            system_rhs = 0;
+
+            WorkStream::run(
+                dof_handler.begin_active(),
+                dof_handler.end(),
+                [this, &neuman_bd](const typename DoFHandler<dim>::active_cell_iterator &cell,
+                    AssemblyScratchData &scratch_data,
+                    AssemblyCopyData &copy_data)
+                {
+                    local_assemble_system(cell, neuman_bd, true, scratch_data, copy_data);
+                },
+                [this, &constraints](const AssemblyCopyData &copy_data)
+                {
+                    constraints.distribute_local_to_global(
+                        copy_data.cell_matrix, copy_data.cell_rhs, copy_data.local_dof_indices,
+                        system_matrix, system_rhs);
+                },
+                AssemblyScratchData(fe, quadrature_formula, face_quadrature_formula),
+                AssemblyCopyData());
+        }
+
+        auto timer = timers.scope("Solve/CG");
+
+        // base mesh can be big, so coarse level is solved iteratively and accurately enough to keep V-cycle symmetric
+        ReductionControl coarse_solver_control(number_of_iterations, 1e-14, 1e-8, false, false);
+        SolverCG<> coarse_cg(coarse_solver_control);
+        PreconditionSSOR<> coarse_preconditioner;
+        coarse_preconditioner.initialize(mg_matrices[0], 1.2);
+        MGCoarseGridIterativeSolver<Vector<double>, SolverCG<>, SparseMatrix<double>, PreconditionSSOR<>>
+            coarse_grid_solver(coarse_cg, mg_matrices[0], coarse_preconditioner);
+
+        mg::SmootherRelaxation<PreconditionSOR<SparseMatrix<double>>, Vector<double>> mg_smoother;
+        mg_smoother.initialize(mg_matrices);
+        mg_smoother.set_steps(2);
+        mg_smoother.set_symmetric(true);
+
+        mg::Matrix<Vector<double>> mg_matrix(mg_matrices);
+        mg::Matrix<Vector<double>> mg_interface_up(mg_interface_matrices);
+        mg::Matrix<Vector<double>> mg_interface_down(mg_interface_matrices);
+
+        Multigrid<Vector<double>> mg(mg_matrix, coarse_grid_solver, mg_transfer, mg_smoother, mg_smoother);
+        mg.set_edge_matrices(mg_interface_down, mg_interface_up);
+
+        PreconditionMG<dim, Vector<double>, MGTransferPrebuilt<Vector<double>>> preconditioner(dof_handler, mg, mg_transfer);
+
+        SolverControl solver_control(number_of_iterations, tollerance);
+        SolverCG<> cg(solver_control);
+        cg.solve(system_matrix, solution, system_rhs, preconditioner);
+
+        number_of_solver_iterations += solver_control.last_step();
+
+        constraints.distribute(solution);
+    }
+
+    void Solver::FarField::clear()
+    {
+        cell_keys.clear();
+        dof_points.clear();
+        n_interface = 0;
+        boundary_conditions.clear();
+        schur_matrix.reinit(0, 0);
+        schur_rhs.reinit(0);
+#ifdef DEAL_II_WITH_UMFPACK
+        interior_inverse.clear();
+#endif
+        interior_matrix.clear();
+        coupling_matrix.clear();
+        interior_sparsity.reinit(0, 0, 0);
+        coupling_sparsity.reinit(0, 0, 0);
+        interior_rhs.reinit(0);
+    }
+
+    bool Solver::match_far_field(const vector<dealii::Point<dim>> &support_points,
+        vector<types::global_dof_index> &far_dofs, vector<bool> &is_far_cell) const
+    {
+        if (far_field.empty()
+            || !(far_field.boundary_conditions == boundary_conditions)
+            || far_field.field_value != field_value
+            || far_field.condensation_radius != condensation_radius)
+            return false;
+
+        // interface should stay far enough from tips, so zone covers growth of next steps
+        for (const auto &tip: refinment_tips)
+            for (unsigned i = 0; i < far_field.n_interface; ++i)
+                if (far_field.dof_points[i].distance(dealii::Point<dim>{tip.x, tip.y}) < condensation_radius / 2)
+                    return false;
+
+        is_far_cell.assign(triangulation.n_active_cells(), false);
+        unsigned n_far_cells = 0;
+        map<pair<double, double>, types::global_dof_index> far_dof_by_point;
+        vector<types::global_dof_index> dof_indices(fe.dofs_per_cell);
+        for (const auto &cell: dof_handler.active_cell_iterators())
+            if (cell->level() == 0 && far_field.cell_keys.count(FarField::cell_key(cell)))
+            {
+                is_far_cell[cell->active_cell_index()] = true;
+                ++n_far_cells;
+                cell->get_dof_indices(dof_indices);
+                for (const auto dof: dof_indices)
+                    far_dof_by_point[{support_points[dof][0], support_points[dof][1]}] = dof;
+            }
+
+        if (n_far_cells != far_field.cell_keys.size() || far_dof_by_point.size() != far_field.dof_points.size())
+            return false;
+
+        far_dofs.resize(far_field.dof_points.size());
+        for (unsigned i = 0; i < far_dofs.size(); ++i)
+        {
+            const auto &p = far_field.dof_points[i];
+            auto it = far_dof_by_point.find({p[0], p[1]});
+            if (it == far_dof_by_point.end())
+                return false;
+            far_dofs[i] = it->second;
+        }
+
+        return true;
+    }
+
+    bool Solver::condense_far_field(const vector<dealii::Point<dim>> &support_points,
+        vector<types::global_dof_index> &far_dofs, vector<bool> &is_far_cell)
+    {
+        far_field.clear();
+
+        // far field is made of unrefined cells, which are further than condensation radius from all tips
+        is_far_cell.assign(triangulation.n_active_cells(), false);
+        vector<typename DoFHandler<dim>::active_cell_iterator> far_cells;
+        for (const auto &cell: dof_handler.active_cell_iterators())
+        {
+            if (cell->level() > 0)
+                continue;
+
+            bool is_far = true;
+            for (unsigned v = 0; v < GeometryInfo<dim>::vertices_per_cell && is_far; ++v)
+                for (const auto &tip: refinment_tips)
+                    if (cell->vertex(v).distance(dealii::Point<dim>{tip.x, tip.y}) <= condensation_radius)
+                    {
+                        is_far = false;
+                        break;
+                    }
+
+            if (is_far)
+            {
+                is_far_cell[cell->active_cell_index()] = true;
+                far_cells.push_back(cell);
+            }
+        }
+
+        if (far_cells.empty() || far_cells.size() == triangulation.n_active_cells())
+            return false;
+
+        // bit 1 - dof of far field cell, bit 2 - dof of zone cell
+        vector<unsigned char> dof_location(dof_handler.n_dofs(), 0);
+        vector<types::global_dof_index> dof_indices(fe.dofs_per_cell);
+        for (const auto &cell: dof_handler.active_cell_iterators())
+        {
+            cell->get_dof_indices(dof_indices);
+            for (const auto dof: dof_indices)
+                dof_location[dof] |= is_far_cell[cell->active_cell_index()] ? 1 : 2;
+        }
+
+        far_dofs.clear();
+        for (types::global_dof_index dof = 0; dof < dof_location.size(); ++dof)
+            if (dof_location[dof] == 3)
+                far_dofs.push_back(dof);
+        const unsigned n_interface = far_dofs.size();
+        for (types::global_dof_index dof = 0; dof < dof_location.size(); ++dof)
+            if (dof_location[dof] == 1)
+                far_dofs.push_back(dof);
+        const unsigned n_far = far_dofs.size(), n_interior = n_far - n_interface;
+
+        vector<unsigned> local_index(dof_handler.n_dofs(), numbers::invalid_unsigned_int);
+        for (unsigned i = 0; i < n_far; ++i)
+            local_index[far_dofs[i]] = i;
+
+        // far field system in local numbering
+        DynamicSparsityPattern far_dsp(n_far, n_far);
+        vector<types::global_dof_index> local_dof_indices(fe.dofs_per_cell);
+        for (const auto &cell: far_cells)
+        {
+            cell->get_dof_indices(dof_indices);
+            for (unsigned i = 0; i < dof_indices.size(); ++i)
+                local_dof_indices[i] = local_index[dof_indices[i]];
+            for (const auto i: local_dof_indices)
+                for (const auto j: local_dof_indices)
+                    far_dsp.add(i, j);
+        }
+        SparsityPattern far_sparsity;
+        far_sparsity.copy_from(far_dsp);
+        SparseMatrix<double> far_matrix(far_sparsity);
+        Vector<double> far_rhs(n_far);
+
+        const auto neuman_bd = boundary_conditions.Get(NEUMAN);
+        AssemblyScratchData scratch_data(fe, quadrature_formula, face_quadrature_formula);
+        AssemblyCopyData copy_data;
+        for (const auto &cell: far_cells)
+        {
+            local_assemble_system(cell, neuman_bd, true, scratch_data, copy_data);
+            for (auto &dof: copy_data.local_dof_indices)
+                dof = local_index[dof];
+            far_matrix.add(copy_data.local_dof_indices, copy_data.cell_matrix);
+            far_rhs.add(copy_data.local_dof_indices, copy_data.cell_rhs);
+        }
+
+        // Dirichlet values of interior dofs are eliminated here, interface ones are applied to zone system
+        std::map<types::global_dof_index, double> boundary_values, interior_boundary_values;
+        for (const auto &[boundary_id, boundary_condition] : boundary_conditions.Get(DIRICHLET))
+            VectorTools::interpolate_boundary_values(
+                dof_handler,
+                boundary_id,
+                Functions::ConstantFunction<dim>(boundary_condition.value),
+                boundary_values);
+        for (const auto &[dof, value]: boundary_values)
+            if (local_index[dof] != numbers::invalid_unsigned_int && local_index[dof] >= n_interface)
+                interior_boundary_values[local_index[dof]] = value;
+        Vector<double> far_solution(n_far);
+        MatrixTools::apply_boundary_values(interior_boundary_values, far_matrix, far_solution, far_rhs);
+
+        // splitting into interface block, interior block and coupling of interior to interface
+        far_field.schur_matrix.reinit(n_interface, n_interface);
+        far_field.schur_rhs.reinit(n_interface);
+        far_field.interior_rhs.reinit(n_interior);
+        DynamicSparsityPattern interior_dsp(n_interior, n_interior), coupling_dsp(n_interior, n_interface);
+        for (unsigned row = n_interface; row < n_far; ++row)
+            for (auto entry = far_matrix.begin(row); entry != far_matrix.end(row); ++entry)
+            {
+                if (entry->column() < n_interface)
+                    coupling_dsp.add(row - n_interface, entry->column());
+                else
+                    interior_dsp.add(row - n_interface, entry->column() - n_interface);
+            }
+        far_field.interior_sparsity.copy_from(interior_dsp);
+        far_field.coupling_sparsity.copy_from(coupling_dsp);
+        far_field.interior_matrix.reinit(far_field.interior_sparsity);
+        far_field.coupling_matrix.reinit(far_field.coupling_sparsity);
+
+        // columns of coupling matrix, they are rows of symmetric interface to interior coupling
+        vector<vector<pair<unsigned, double>>> coupling_columns(n_interface);
+        for (unsigned row = 0; row < n_far; ++row)
+        {
+            for (auto entry = far_matrix.begin(row); entry != far_matrix.end(row); ++entry)
+            {
+                const unsigned column = entry->column();
+                if (row < n_interface && column < n_interface)
+                    far_field.schur_matrix(row, column) += entry->value();
+                else if (row >= n_interface && column < n_interface)
+                {
+                    far_field.coupling_matrix.set(row - n_interface, column, entry->value());
+                    coupling_columns[column].emplace_back(row - n_interface, entry->value());
+                }
+                else if (row >= n_interface)
+                    far_field.interior_matrix.set(row - n_interface, column - n_interface, entry->value());
+            }
+
+            if (row < n_interface)
+                far_field.schur_rhs(row) = far_rhs(row);
+            else
+                far_field.interior_rhs(row - n_interface) = far_rhs(row);
+        }
+
+#ifdef DEAL_II_WITH_UMFPACK
+        far_field.interior_inverse.initialize(far_field.interior_matrix);
+#endif
+
+        // S = A_II - A_IF A_FF^-1 A_FI and g = b_I - A_IF A_FF^-1 b_F
+        auto interface_product = [&coupling_columns](const unsigned i, const Vector<double> &x)
+        {
+            double product = 0;
+            for (const auto &[row, value]: coupling_columns[i])
+                product += value * x(row);
+            return product;
+        };
+
+        Vector<double> column(n_interior), x(n_interior);
+        for (unsigned j = 0; j < n_interface; ++j)
+        {
+            if (coupling_columns[j].empty())
+                continue;
+
+            column = 0;
+            for (const auto &[row, value]: coupling_columns[j])
+                column(row) = value;
+            solve_far_field_interior(x, column);
+            for (unsigned i = 0; i < n_interface; ++i)
+                far_field.schur_matrix(i, j) -= interface_product(i, x);
+        }
+
+        solve_far_field_interior(x, far_field.interior_rhs);
+        for (unsigned i = 0; i < n_interface; ++i)
+            far_field.schur_rhs(i) -= interface_product(i, x);
+
+        for (const auto &cell: far_cells)
+            far_field.cell_keys.insert(FarField::cell_key(cell));
+        for (const auto dof: far_dofs)
+            far_field.dof_points.push_back(support_points[dof]);
+        far_field.n_interface = n_interface;
+        far_field.boundary_conditions = boundary_conditions;
+        far_field.field_value = field_value;
+        far_field.condensation_radius = condensation_radius;
+
+        return true;
+    }
+
+    void Solver::solve_far_field_interior(Vector<double> &x, const Vector<double> &b) const
+    {
+#ifdef DEAL_II_WITH_UMFPACK
+        far_field.interior_inverse.vmult(x, b);
+#else
+        x = 0;
+        if (b.l2_norm() == 0)
+            return;
+        SolverControl solver_control(number_of_iterations, 1e-14 * b.l2_norm());
+        SolverCG<> cg(solver_control);
+        PreconditionSSOR<> preconditioner;
+        preconditioner.initialize(far_field.interior_matrix, 1.2);
+        cg.solve(far_field.interior_matrix, x, b, preconditioner);
+#endif
+    }
+
+    bool Solver::solve_condensed()
+    {
+        if (refinment_tips.empty())
+            return false;
+
+        vector<dealii::Point<dim>> support_points(dof_handler.n_dofs());
+        DoFTools::map_dofs_to_support_points(MappingQ1<dim>(), dof_handler, support_points);
+
+        vector<types::global_dof_index> far_dofs;
+        vector<bool> is_far_cell;
+        if (!match_far_field(support_points, far_dofs, is_far_cell))
+        {
+            auto timer = timers.scope("Solve/Condensation");
+            if (!condense_far_field(support_points, far_dofs, is_far_cell))
+                return false;
+            timers.count("FarFieldCondensations");
+        }
+        const unsigned n_interface = far_field.n_interface;
+
+        {
+            auto timer = timers.scope("Solve/Assembly");
+            vector<typename DoFHandler<dim>::active_cell_iterator> zone_cells;
+            for (const auto &cell: dof_handler.active_cell_iterators())
+                if (!is_far_cell[cell->active_cell_index()])
+                    zone_cells.push_back(cell);
+
+            // zone cells, dense interface block of Schur complement and decoupled interior far field dofs
+            DynamicSparsityPattern dsp(dof_handler.n_dofs(), dof_handler.n_dofs());
+            vector<types::global_dof_index> dof_indices(fe.dofs_per_cell);
+            for (const auto &cell: zone_cells)
+            {
+                cell->get_dof_indices(dof_indices);
+                for (const auto i: dof_indices)
+                    for (const auto j: dof_indices)
+                        dsp.add(i, j);
+            }
+            for (unsigned i = 0; i < n_interface; ++i)
+                for (unsigned j = 0; j < n_interface; ++j)
+                    dsp.add(far_dofs[i], far_dofs[j]);
+            for (unsigned i = n_interface; i < far_dofs.size(); ++i)
+                dsp.add(far_dofs[i], far_dofs[i]);
+            hanging_node_constraints.condense(dsp);
+
+            system_matrix.clear();
+            zone_sparsity_pattern.copy_from(dsp);
+            system_matrix.reinit(zone_sparsity_pattern);
+            system_rhs = 0;
+
+            const auto neuman_bd = boundary_conditions.Get(NEUMAN);
+            WorkStream::run(
+                zone_cells.cbegin(),
+                zone_cells.cend(),
+                [this, &neuman_bd](const typename vector<typename DoFHandler<dim>::active_cell_iterator>::const_iterator &cell,
+                    AssemblyScratchData &scratch_data,
+                    AssemblyCopyData &copy_data)
+                {
+                    local_assemble_system(*cell, neuman_bd, true, scratch_data, copy_data);
+                },
+                [this](const AssemblyCopyData &copy_data)
+                {
+                    copy_local_to_global(copy_data);
+                },
+                AssemblyScratchData(fe, quadrature_formula, face_quadrature_formula),
+                AssemblyCopyData());
+
+            for (unsigned i = 0; i < n_interface; ++i)
+            {
+                for (unsigned j = 0; j < n_interface; ++j)
+                    system_matrix.add(far_dofs[i], far_dofs[j], far_field.schur_matrix(i, j));
+                system_rhs(far_dofs[i]) += far_field.schur_rhs(i);
+            }
+            // interior far field values are recovered after solution
+            for (unsigned i = n_interface; i < far_dofs.size(); ++i)
+                system_matrix.set(far_dofs[i], far_dofs[i], 1.);
+
+            hanging_node_constraints.condense(system_matrix);
+            hanging_node_constraints.condense(system_rhs);
+
+            std::map<types::global_dof_index, double> boundary_values;
+            for (const auto &[boundary_id, boundary_condition] : boundary_conditions.Get(DIRICHLET))
+                VectorTools::interpolate_boundary_values(
+                    dof_handler,
+                    boundary_id,
+                    Functions::ConstantFunction<dim>(boundary_condition.value),
+                    boundary_values);
+
+            MatrixTools::apply_boundary_values(
+                boundary_values,
+                system_matrix,
+                solution,
+                system_rhs);
+        }
+
+        solve();
+
+        {
+            auto timer = timers.scope("Solve/FarFieldRecovery");
+            // u_F = A_FF^-1 (b_F - A_FI u_I)
+            const unsigned n_interior = far_dofs.size() - n_interface;
+            Vector<double> interface_solution(n_interface), rhs(n_interior), x(n_interior);
+            for (unsigned i = 0; i < n_interface; ++i)
+                interface_solution(i) = solution(far_dofs[i]);
+            far_field.coupling_matrix.vmult(rhs, interface_solution);
+            rhs.sadd(-1., far_field.interior_rhs);
+            solve_far_field_interior(x, rhs);
+            for (unsigned i = 0; i < n_interior; ++i)
+                solution(far_dofs[n_interface + i]) = x(i);
+        }
+
+        return true;
     }
 
     double Solver::value(const River::Point &p) const
@@ -242,6 +1366,144 @@ namespace River
         return field_function.value(dealii::Point<dim>{p.x, p.y});
     }
 
+    void Solver::build_cell_buckets()
+    {
+        auto timer = timers.scope("Solve/CellBuckets");
+        cell_buckets.clear();
+        if (triangulation.n_active_cells() == 0)
+            return;
+
+        // bounding box of whole region
+        dealii::Point<dim> p_min = triangulation.begin_active()->vertex(0), p_max = p_min;
+        for (const auto &cell : triangulation.active_cell_iterators())
+            for (unsigned v = 0; v < GeometryInfo<dim>::vertices_per_cell; ++v)
+                for (unsigned d = 0; d < dim; ++d)
+                {
+                    p_min[d] = min(p_min[d], cell->vertex(v)[d]);
+                    p_max[d] = max(p_max[d], cell->vertex(v)[d]);
+                }
+
+        // around four cells per bucket
+        const double 
+            width = max(p_max[0] - p_min[0], EPS),
+            height = max(p_max[1] - p_min[1], EPS),
+            n_buckets = max(1., triangulation.n_active_cells() / 4.);
+        cell_bucket_size = sqrt(width * height / n_buckets);
+        cell_buckets_nx = (unsigned)ceil(width / cell_bucket_size);
+        cell_buckets_ny = (unsigned)ceil(height / cell_bucket_size);
+        cell_buckets_origin = p_min;
+        cell_buckets.resize(cell_buckets_nx * cell_buckets_ny);
+
+        for (const auto &cell : dof_handler.active_cell_iterators())
+        {
+            dealii::Point<dim> c_min = cell->vertex(0), c_max = c_min;
+            for (unsigned v = 1; v < GeometryInfo<dim>::vertices_per_cell; ++v)
+                for (unsigned d = 0; d < dim; ++d)
+                {
+                    c_min[d] = min(c_min[d], cell->vertex(v)[d]);
+                    c_max[d] = max(c_max[d], cell->vertex(v)[d]);
+                }
+
+            const unsigned
+                i_min = min(cell_buckets_nx - 1, (unsigned)((c_min[0] - p_min[0]) / cell_bucket_size)),
+                i_max = min(cell_buckets_nx - 1, (unsigned)((c_max[0] - p_min[0]) / cell_bucket_size)),
+                j_min = min(cell_buckets_ny - 1, (unsigned)((c_min[1] - p_min[1]) / cell_bucket_size)),
+                j_max = min(cell_buckets_ny - 1, (unsigned)((c_max[1] - p_min[1]) / cell_bucket_size));
+
+            for (unsigned j = j_min; j <= j_max; ++j)
+                for (unsigned i = i_min; i <= i_max; ++i)
+                    cell_buckets[j * cell_buckets_nx + i].push_back(cell);
+        }
+    }
+
+    bool Solver::locate_point(const dealii::Point<dim> &p, typename DoFHandler<dim>::active_cell_iterator &cell, 
+        bool has_hint, dealii::Point<dim> &unit_point) const
+    {
+        const auto &mapping = StaticMappingQ1<dim>::mapping;
+
+        auto is_inside = [&](const typename DoFHandler<dim>::active_cell_iterator &c)
+        {
+            // cheap bounding box test before inverse mapping
+            dealii::Point<dim> c_min = c->vertex(0), c_max = c_min;
+            for (unsigned v = 1; v < GeometryInfo<dim>::vertices_per_cell; ++v)
+                for (unsigned d = 0; d < dim; ++d)
+                {
+                    c_min[d] = min(c_min[d], c->vertex(v)[d]);
+                    c_max[d] = max(c_max[d], c->vertex(v)[d]);
+                }
+            for (unsigned d = 0; d < dim; ++d)
+                if (p[d] < c_min[d] - EPS || p[d] > c_max[d] + EPS)
+                    return false;
+
+            try
+            {
+                unit_point = mapping.transform_real_to_unit_cell(c, p);
+            }
+            catch (const typename Mapping<dim>::ExcTransformationFailed &error)
+            {
+                return false;
+            }
+            return GeometryInfo<dim>::is_inside_unit_cell(unit_point, 1e-10);
+        };
+
+        if (has_hint && is_inside(cell))
+            return true;
+
+        if (p[0] < cell_buckets_origin[0] || p[1] < cell_buckets_origin[1])
+            return false;
+
+        const unsigned 
+            i = (unsigned)((p[0] - cell_buckets_origin[0]) / cell_bucket_size),
+            j = (unsigned)((p[1] - cell_buckets_origin[1]) / cell_bucket_size);
+        if (i >= cell_buckets_nx || j >= cell_buckets_ny)
+            return false;
+
+        for (const auto &c : cell_buckets[j * cell_buckets_nx + i])
+            if (is_inside(c))
+            {
+                cell = c;
+                return true;
+            }
+
+        return false;
+    }
+
+    void Solver::values(const t_PointList &points, vector<double> &point_values, vector<bool> &inside) const
+    {
+        point_values.assign(points.size(), 0);
+        inside.assign(points.size(), false);
+
+        // unit coordinates and indexes of points grouped by cell
+        map<typename DoFHandler<dim>::active_cell_iterator, pair<vector<dealii::Point<dim>>, vector<size_t>>> cell_points;
+
+        typename DoFHandler<dim>::active_cell_iterator hint_cell;
+        bool has_hint = false;
+        dealii::Point<dim> unit_point;
+        for (size_t i = 0; i < points.size(); ++i)
+            if (locate_point(dealii::Point<dim>{points[i].x, points[i].y}, hint_cell, has_hint, unit_point))
+            {
+                has_hint = true;
+                inside[i] = true;
+                auto &[unit_points, indexes] = cell_points[hint_cell];
+                unit_points.push_back(unit_point);
+                indexes.push_back(i);
+            }
+
+        vector<double> cell_values;
+        for (const auto &[cell, unit_points_and_indexes] : cell_points)
+        {
+            const auto &[unit_points, indexes] = unit_points_and_indexes;
+            const dealii::Quadrature<dim> quadrature(unit_points);
+            FEValues<dim> fe_values(StaticMappingQ1<dim>::mapping, fe, quadrature, update_values);
+            fe_values.reinit(cell);
+
+            cell_values.resize(unit_points.size());
+            fe_values.get_function_values(solution, cell_values);
+            for (size_t k = 0; k < indexes.size(); ++k)
+                point_values[indexes[k]] = cell_values[k];
+        }
+    }
+
     double Solver::valueSafe(const double x, const double y) const
     {
         Functions::FEFieldFunction<dim> field_function(dof_handler, solution);
@@ -260,6 +1522,7 @@ namespace River
 
     void Solver::refine_grid()
     {
+        auto timer = timers.scope("Solve/AdaptiveRefinement");
         Vector<float> estimated_error_per_cell(triangulation.n_active_cells());
 
         KellyErrorEstimator<dim>::estimate(dof_handler,
@@ -273,6 +1536,8 @@ namespace River
                                                         refinment_fraction, coarsening_fraction);
 
         triangulation.execute_coarsening_and_refinement();
+        mesh_fingerprint = 0;
+        is_system_reused = false;
     }
 
     double Solver::max_cell_error()
@@ -304,6 +1569,7 @@ namespace River
 
     void Solver::static_refine_grid(unsigned int num_of_static_refinments, const double integration_radius, const t_PointList &tips_points)
     {
+        auto timer = timers.scope("OpenMesh/StaticRefinement");
         // iterating over refinment steps
         for (unsigned step = 0; step < num_of_static_refinments; ++step)
         {
@@ -328,6 +1594,9 @@ namespace River
             }
             triangulation.execute_coarsening_and_refinement();
         }
+        refinment_tips = tips_points;
+        mesh_fingerprint = 0;
+        is_system_reused = false;
     }
 
     vector<double> Solver::integrate(const IntegrationParams &integ, const Point &point, const double angle)
@@ -388,56 +1657,87 @@ namespace River
         return series_params;
     }
 
-    vector<double> Solver::integrate_new(const IntegrationParams &integ, const Point &tip_coord, const double angle)
+    shared_ptr<const IntegrationStencil> Solver::get_integration_stencil(const IntegrationParams &integ)
     {
-        Functions::FEFieldFunction<dim> field_function(dof_handler, solution);
+        lock_guard<mutex> lock(integration_stencil_mutex);
+        if (!integration_stencil || !(integration_stencil->integ == integ))
+            integration_stencil = make_shared<const IntegrationStencil>(integ);
+        return integration_stencil;
+    }
 
-        // Parameters definition
-        vector<double>
-            integral(3, 0),
-            normalization_integral(3, 0),
-            series_params(3, 0);                  // Series params
-        auto drho = integ.integration_radius / 8; // 8 higher value gives better results
-        for (double rho = drho; rho < integ.integration_radius; rho += drho)
-        {
-            auto weight_func_value = integ.WeightFunction(rho);
-            for (double phi = 0; phi < 2 * M_PI; phi += M_PI / 4200 /*4200*/ / rho * integ.integration_radius)
-            {
-                River::Polar cylind_coord{rho, phi};
-                River::Point
-                    abs_coord{tip_coord.x + rho * cos(phi + angle), tip_coord.y + rho * sin(phi + angle)},
-                    rel_coord = abs_coord - tip_coord;
-                double value;
-                try
-                {
-                    value = field_function.value(dealii::Point<dim>{abs_coord.x, abs_coord.y});
-                }
-                catch (const VectorTools::ExcPointNotAvailableHere &error)
-                {
-                    continue;
-                }
+    shared_ptr<const IntegrationStencil> Solver::get_spectral_stencil(const IntegrationParams &integ, const unsigned level)
+    {
+        lock_guard<mutex> lock(integration_stencil_mutex);
+        if (!spectral_stencils.empty() && !(spectral_stencils.begin()->second->integ == integ))
+            spectral_stencils.clear();
+
+        auto &stencil = spectral_stencils[level];
+        if (!stencil)
+            stencil = make_shared<const IntegrationStencil>(integ, level);
+        return stencil;
+    }
 
-                // cycle over all series parameters order
-                for (unsigned param_index = 0; param_index < series_params.size(); ++param_index)
-                {
-                    // preevaluate basevector value
-                    auto base_vector_value = integ.BaseVectorFinal(param_index + 1, angle, rel_coord.x, rel_coord.y);
+    vector<double> Solver::integrate_new(const IntegrationParams &integ, const Point &tip_coord, const double angle)
+    {
+        return integrate_stencil(*get_integration_stencil(integ), tip_coord, angle);
+    }
 
-                    // integration of weighted integral..
-                    integral[param_index] += value * weight_func_value * base_vector_value * rho;
+    vector<double> Solver::integrate_spectral(const IntegrationParams &integ, const Point &tip_coord, const double angle)
+    {
+        size_t n_samples = 0;
+        return integrate_spectral(integ, tip_coord, angle, n_samples);
+    }
 
-                    //.. and its normalization integral
-                    normalization_integral[param_index] += weight_func_value * pow(base_vector_value, 2) * rho;
-                }
+    vector<double> Solver::integrate_spectral(const IntegrationParams &integ, const Point &tip_coord, const double angle, size_t &n_samples)
+    {
+        // samples of previous levels are first samples of next one, so only new ones are evaluated
+        vector<double> sample_values, mask;
+        auto integrate_level = [&](const unsigned level)
+        {
+            const auto stencil = get_spectral_stencil(integ, level);
+            const auto sample_points = stencil->Points(tip_coord, angle, sample_values.size());
+            vector<double> level_values;
+            vector<bool> inside;
+            values(sample_points, level_values, inside);
+            sample_values.insert(sample_values.end(), level_values.begin(), level_values.end());
+            mask.insert(mask.end(), inside.begin(), inside.end());
+
+            return stencil->SeriesParameters(sample_values, mask);
+        };
+
+        auto series_params = integrate_level(0);
+        const auto max_levels = min(integ.spectral_max_levels, IntegrationParams::spectral_levels_limit);
+        for (unsigned level = 1; level <= max_levels; ++level)
+        {
+            const auto prev_series_params = series_params;
+            series_params = integrate_level(level);
+
+            double max_diff = 0, max_value = EPS;
+            for (unsigned i = 0; i < series_params.size(); ++i)
+            {
+                max_diff = max(max_diff, abs(series_params[i] - prev_series_params[i]));
+                max_value = max(max_value, abs(series_params[i]));
             }
-        }
 
-        for (unsigned i = 0; i < integral.size(); ++i)
-            series_params[i] = integral[i] / normalization_integral[i];
+            if (max_diff / max_value < integ.spectral_eps)
+                break;
+        }
+        n_samples = sample_values.size();
 
         return series_params;
     }
 
+    vector<double> Solver::integrate_stencil(const IntegrationStencil &stencil, const Point &tip_coord, const double angle)
+    {
+        // all sample points around tip are evaluated in one batch
+        const auto sample_points = stencil.Points(tip_coord, angle);
+        vector<double> sample_values;
+        vector<bool> inside;
+        values(sample_points, sample_values, inside);
+
+        return stencil.SeriesParameters(sample_values, vector<double>(inside.begin(), inside.end()));
+    }
+
     vector<double> Solver::integral_value(const Functions::FEFieldFunction<2> &field_function, 
         const double rho, double phi, const River::Point &tip_coord, const double angle,
         const IntegrationParams &integ)
@@ -711,8 +2011,56 @@ namespace River
         // grid_out.write_eps(triangulation, out);
     }
 
+    ///Gives access to patches built by DataOut.
+    template <int dim>
+    class PatchesDataOut: public DataOut<dim>
+    {
+        public:
+            using DataOut<dim>::get_patches;
+            using DataOut<dim>::get_dataset_names;
+    };
+
+    ///Copy of patches, which doesn't refer to dof handler and solution, so it can be written while they change.
+    template <int dim>
+    class PatchesSnapshot: public DataOutInterface<dim>
+    {
+        public:
+            vector<DataOutBase::Patch<dim>> patches;
+            vector<string> dataset_names;
+
+        protected:
+            const vector<DataOutBase::Patch<dim>>& get_patches() const override
+            {
+                return patches;
+            }
+
+            vector<string> get_dataset_names() const override
+            {
+                return dataset_names;
+            }
+    };
+
+    void Solver::output_results(const string file_name, AsyncWriter &writer) const
+    {
+        PatchesDataOut<dim> data_out;
+        data_out.attach_dof_handler(dof_handler);
+        data_out.add_data_vector(solution, "solution");
+        data_out.build_patches();
+
+        auto snapshot = make_shared<PatchesSnapshot<dim>>();
+        snapshot->patches = data_out.get_patches();
+        snapshot->dataset_names = data_out.get_dataset_names();
+        writer.push([snapshot, file_name]()
+        {
+            ofstream output(file_name + ".vtk");
+            output.precision(20); // Fix for paraview
+            snapshot->write_vtk(output);
+        });
+    }
+
     void Solver::run()
     {
+        number_of_solver_iterations = 0;
         for (unsigned cycle = 0; cycle <= num_of_adaptive_refinments; ++cycle)
         {
             if (verbose) cout <<  "adaptive mesh solver cycle-#" + to_string(cycle) + "---------------------------" << endl;
@@ -722,13 +2070,36 @@ namespace River
             if (verbose) cout <<  "   Number of active cells:" << endl;
             if (verbose) cout <<  "\t" + to_string(triangulation.n_active_cells()) << endl;
 
-            setup_system();
+            if (cycle == 0 && is_system_reused)
+            {
+                // triangulation is unchanged, so previous solution is the best initial guess
+                if (!warm_start)
+                    solution = 0;
+                system_rhs = 0;
+            }
+            else
+            {
+                setup_system();
+
+                if (warm_start && cycle == 0)
+                    interpolate_previous_solution();
+            }
 
             if (verbose) cout <<  "   Number of degrees of freedom:" << endl;
             if (verbose) cout <<  "\t" + to_string(dof_handler.n_dofs()) << endl;
             
-            assemble_system(boundary_conditions);
-            solve();
+            if (matrix_free)
+                solve_matrix_free();
+            else if (preconditioner_type == 3)
+                solve_multigrid();
+            else if (!is_condensation_used() || !solve_condensed())
+            {
+                assemble_system(boundary_conditions);
+                solve();
+            }
+
+            if (verbose) cout <<  "   Number of solver iterations:" << endl;
+            if (verbose) cout <<  "\t" + to_string(number_of_solver_iterations) << endl;
         }
     }
 
@@ -738,6 +2109,12 @@ namespace River
         number_of_iterations = s.number_of_iterations;
         num_of_adaptive_refinments = s.num_of_adaptive_refinments;
         num_of_static_refinments = s.num_of_static_refinments;
+        preconditioner_type = s.preconditioner_type;
+        warm_start = s.warm_start;
+        matrix_free = s.matrix_free;
+        condensation_radius = s.condensation_radius;
+        mixed_precision = s.mixed_precision;
+        direct_solver = s.direct_solver;
         field_value = s.field_value;
         refinment_fraction = s.refinment_fraction;
         coarsening_fraction = s.coarsening_fraction;
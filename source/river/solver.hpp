@@ -25,6 +25,8 @@
 #include <deal.II/base/convergence_table.h>
 #include <deal.II/base/logstream.h>
 #include <deal.II/base/types.h>
+#include <deal.II/base/work_stream.h>
+#include <deal.II/base/multithread_info.h>
 
 #include <deal.II/grid/tria.h>
 #include <deal.II/grid/tria_accessor.h>
@@ -37,6 +39,7 @@
 
 #include <deal.II/fe/fe_q.h>
 #include <deal.II/fe/fe_values.h>
+#include <deal.II/fe/mapping_q1.h>
 
 #include <deal.II/dofs/dof_handler.h>
 #include <deal.II/dofs/dof_tools.h>
@@ -50,6 +53,25 @@
 #include <deal.II/lac/solver_cg.h>
 #include <deal.II/lac/precondition.h>
 #include <deal.II/lac/affine_constraints.h>
+#include <deal.II/lac/la_parallel_vector.h>
+#ifdef DEAL_II_WITH_TRILINOS
+#include <deal.II/lac/trilinos_precondition.h>
+#endif
+#ifdef DEAL_II_WITH_UMFPACK
+#include <deal.II/lac/sparse_direct.h>
+#endif
+
+#include <deal.II/multigrid/mg_constrained_dofs.h>
+#include <deal.II/multigrid/mg_transfer.h>
+#include <deal.II/multigrid/mg_tools.h>
+#include <deal.II/multigrid/mg_coarse.h>
+#include <deal.II/multigrid/mg_smoother.h>
+#include <deal.II/multigrid/mg_matrix.h>
+#include <deal.II/multigrid/multigrid.h>
+
+#include <deal.II/matrix_free/matrix_free.h>
+#include <deal.II/matrix_free/fe_evaluation.h>
+#include <deal.II/matrix_free/operators.h>
 
 #include <deal.II/numerics/vector_tools.h>
 #include <deal.II/numerics/matrix_tools.h>
@@ -63,13 +85,19 @@
 #include <array>
 #include <unordered_map>
 #include <map>
+#include <set>
 #include <utility>
 #include <functional>
+#include <algorithm>
+#include <memory>
+#include <mutex>
 #include <math.h>
 ///\endcond
 
 #include "boundary.hpp"
 #include "tethex.hpp"
+#include "timers.hpp"
+#include "writer.hpp"
 
 using namespace dealii;
 
@@ -101,6 +129,18 @@ namespace River
         /// Rho integration step
         double n_rho = 8;
 
+        /// Integration method used for series parameters: 0 - uniform polar grid(River::Solver::integrate_new), 1 - nested Fejer grids(River::Solver::integrate_spectral).
+        unsigned integration_method = 0;
+
+        /// Target relative accuracy of series parameters, used by nested Fejer grids integration.
+        double spectral_eps = 1e-6;
+
+        /// Maximal number of doublings of nested Fejer grid, no more then spectral_levels_limit.
+        unsigned spectral_max_levels = 4;
+
+        /// Upper limit of spectral_max_levels, grid of this level has 260k samples per tip.
+        static constexpr unsigned spectral_levels_limit = 6;
+
         /// Weight function used in computation of series parameters.
         inline double WeightFunction(const double r) const
         {
@@ -131,6 +171,58 @@ namespace River
         bool operator==(const IntegrationParams &ip) const;
     };
 
+    /*! \brief Precomputed polar grid of samples used by River::Solver::integrate_new().
+        \details Grid depends only on River::IntegrationParams. Samples are stored in tip frame, where tip direction
+        is x axis, so base vectors and weights don't depend on tip angle. At use time only offsets are rotated by tip angle
+        and integration becomes dot product of solution values with precomputed coefficients.
+     */
+    class IntegrationStencil
+    {
+    public:
+        IntegrationStencil() = default;
+
+        /// Builds samples of uniform polar grid around tip.
+        explicit IntegrationStencil(const IntegrationParams &integ);
+
+        /*! \brief Builds tensor grid of Fejer second rule points of refinment \p level in t, where rho = integration_radius * t^2, and in phi.
+            \details Grid has 4 * 2^level intervals in t and 16 * 2^level intervals in phi from -pi to pi. Change of variable
+            makes half-integer powers of rho smooth, and phi = +-pi, where solution isn't smooth because of river, is end of
+            interval, which isn't sampled. Grids are nested: first samples of \p level are all samples of \p level - 1 in
+            same order, so their values can be reused.
+        */
+        IntegrationStencil(const IntegrationParams &integ, const unsigned level);
+
+        /// Returns absolute coordinates of samples starting from \p first for tip with \p tip_coord and direction \p angle.
+        t_PointList Points(const River::Point &tip_coord, const double angle, const size_t first = 0) const;
+
+        /// Number of samples.
+        size_t size() const
+        {
+            return dx.size();
+        }
+
+        /*! \brief Series parameters from values of solution at samples.
+            \param[in] sample_values Values at samples, zero outside of region.
+            \param[in] mask One for samples inside of region and zero otherwise.
+        */
+        vector<double> SeriesParameters(const vector<double> &sample_values, const vector<double> &mask) const;
+
+        /// Parameters stencil was built with.
+        IntegrationParams integ;
+
+        /// Offsets of samples relative to tip in tip frame.
+        vector<double> dx, dy;
+
+        /// Weight function times base vector times rho, for each series parameter order.
+        array<vector<double>, 3> weighted_base;
+
+        /// Weight function times base vector squared times rho, for each series parameter order.
+        array<vector<double>, 3> weighted_base_squared;
+
+        /// Sums of weighted_base_squared, normalization integrals if all samples lie inside region.
+        array<double, 3> normalization_integral = {0, 0, 0};
+    };
+
     class Quadrature
     {
         public:
@@ -231,6 +323,43 @@ namespace River
         /// Polynom degree of quadrature integration.
         unsigned quadrature_degree = 3;
 
+        /*! \brief Preconditioner of CG solver(0 - SSOR, 1 - Jacobi, 2 - algebraic multigrid, needs Deal.II with Trilinos,
+            3 - geometric multigrid over levels of static refinment).
+            \details Geometric multigrid limits difference of refinment levels at vertices, so static refinment refines some more cells.
+        */
+        unsigned preconditioner_type = 0;
+
+        /// If true, CG starts from previous growth step solution interpolated onto new mesh instead of zero vector.
+        bool warm_start = false;
+
+        /*! \brief Number of threads used by system assembly(0 - all available cores).
+            \details Thread limit is process wide, so it is applied once by program(see main()), not by Solver.
+        */
+        unsigned num_of_threads = 0;
+
+        /*! \brief If true, Laplace operator is applied matrix free(sum factorization on cells) and system matrix isn't stored.
+            \details Supported for quadrature_degree(FE_Q degree) from 1 to 4.
+        */
+        bool matrix_free = false;
+
+        /*! \brief Radius around tips of zone, which is assembled and solved at each step, 0 - whole region is solved.
+            \details Rest of region(far field) is condensed into Schur complement on interface of zone and is reused while
+            far field mesh is the same and tips are further than half of radius from interface(see Solver::solve_condensed()).
+        */
+        double condensation_radius = 0;
+
+        /*! \brief If true, CG iterations and preconditioner run on single precision copy of system matrix, and solution is
+            corrected by residual evaluated in double precision until tollerance is reached(see Solver::solve_mixed_precision()).
+            \details Used with SSOR and Jacobi preconditioners.
+        */
+        bool mixed_precision = false;
+
+        /*! \brief If true, assembled system is solved by sparse direct solver(UMFPACK, needs Deal.II built with it) instead of CG.
+            \details Factorization is reused while system matrix is the same, e.g. when same mesh is solved several times by
+            non linear and backward steps(see Solver::solve_direct()). Matrix free solver and geometric multigrid ignore it.
+        */
+        bool direct_solver = false;
+
         /// Renumbering algorithm(0 - none, 1 - cuthill McKee, 2 - hierarchical, 3 - random, ...) for the degrees of freedom on a triangulation.
         unsigned renumbering_type = 0;
 
@@ -254,10 +383,14 @@ namespace River
         Solver(
             const SolverParams& solver_params, 
             const bool verb):
+            // geometric multigrid needs at most one level difference between cells sharing vertex
+            triangulation{solver_params.preconditioner_type == 3 ? 
+                Triangulation<dim>::limit_level_difference_at_vertices : Triangulation<dim>::none},
             dof_handler{triangulation},
             fe{solver_params.quadrature_degree},
             quadrature_formula{solver_params.quadrature_degree},
-            face_quadrature_formula{solver_params.quadrature_degree}
+            face_quadrature_formula{solver_params.quadrature_degree},
+            previous_dof_handler{previous_triangulation}
 
         {
             verbose = verb;
@@ -267,6 +400,12 @@ namespace River
             refinment_fraction = solver_params.refinment_fraction;
             field_value = solver_params.field_value;
             num_of_static_refinments = solver_params.static_refinment_steps;
+            preconditioner_type = solver_params.preconditioner_type;
+            warm_start = solver_params.warm_start;
+            matrix_free = solver_params.matrix_free;
+            condensation_radius = solver_params.condensation_radius;
+            mixed_precision = solver_params.mixed_precision;
+            direct_solver = solver_params.direct_solver;
         };
 
         ~Solver() { clear(); }
@@ -283,12 +422,51 @@ namespace River
         /// Number of static mesh refinments. Splits elements without resolving.
         unsigned num_of_static_refinments = 0;
 
+        /// Preconditioner of CG solver(0 - SSOR, 1 - Jacobi, 2 - algebraic multigrid, 3 - geometric multigrid, see solve_multigrid()).
+        unsigned preconditioner_type = 0;
+
+        /// If true, initial guess of CG is interpolated from previous solution(see save_previous_solution()).
+        bool warm_start = false;
+
+        /// If true, system is solved by matrix free Laplace operator(see solve_matrix_free()).
+        bool matrix_free = false;
+
+        /// Radius around tips of zone which is solved at each step, far field is condensed, 0 - off(see solve_condensed()).
+        double condensation_radius = 0;
+
+        /// If true, system is solved by single precision CG with double precision residual correction(see solve_mixed_precision()).
+        bool mixed_precision = false;
+
+        /// If true, system is solved by sparse direct solver with reused factorization(see solve_direct()).
+        bool direct_solver = false;
+
+        /// Number of CG iterations done by last call of run(), summed over adaptive cycles.
+        unsigned number_of_solver_iterations = 0;
+
+        /// True if degrees of freedom, sparsity pattern and stiffness matrix are kept from previous run()(see OpenMeshIfChanged()).
+        bool is_system_reused = false;
+
+        /// Time of solver phases, named as subphases of "OpenMesh", "Solve" and "Integration".
+        Timers timers;
+
         /// Open mesh data from file. Msh 2 format.
         void OpenMesh(const string fileName = "river.msh");
 
         /// Open mesh data from object.
         void OpenMesh(const tethex::Mesh &mesh);
 
+        /// Creates triangulation directly from flat arrays of tethex::FlatMesh.
+        void OpenMesh(const tethex::FlatMesh &mesh);
+
+        /*! \brief Creates triangulation from \p mesh and refines it statically, unless they are the same as at previous call.
+            \details Mesh, tips and refinment parameters are compared by fingerprint(see tethex::FlatMesh::fingerprint()).
+            If they are unchanged, triangulation, degrees of freedom numbering, sparsity pattern and stiffness matrix are kept,
+            so next run() assembles only right hand side and applies boundary conditions. Otherwise previous solution is saved
+            for warm start, solver is cleared and mesh is opened again.
+            \return True if current triangulation is reused.
+        */
+        bool OpenMeshIfChanged(const tethex::FlatMesh &mesh, unsigned int num_of_static_refinments, const double integration_radius, const t_PointList &tips_points);
+
         ///Sets boundary conditions of solver.
         void setBoundaryConditions(const BoundaryConditions &boundary_conds);
 
@@ -312,12 +490,25 @@ namespace River
         /// Save results to VTK file.
         void output_results(const string file_name) const;
 
+        /// Builds patches of solution in calling thread and queues writing of them to VTK file to \p writer.
+        void output_results(const string file_name, AsyncWriter &writer) const;
+
         /// Interation of series parameters around tips points.
         vector<double> integrate(const IntegrationParams &integ, const Point &point, const double angle);
 
         /// Interation of series parameters around tips points using better values evaluation, but slower.
         vector<double> integrate_new(const IntegrationParams &integ, const Point &point, const double angle);
 
+        /*! \brief Interation of series parameters around tips points using nested Fejer grids(see IntegrationStencil).
+            \details Grid is doubled in both directions until relative change of series parameters is less then
+            River::IntegrationParams::spectral_eps or River::IntegrationParams::spectral_max_levels is reached.
+            Only new samples of each level are evaluated.
+        */
+        vector<double> integrate_spectral(const IntegrationParams &integ, const Point &point, const double angle);
+
+        /// Same as integrate_spectral(), \p n_samples is set to number of evaluated samples.
+        vector<double> integrate_spectral(const IntegrationParams &integ, const Point &point, const double angle, size_t &n_samples);
+
         /// Interation of series parameters around tips points using trapezoidal recursive integration.
         vector<double> integrate_trap(const IntegrationParams &integ, const Point &point, const double angle);
 
@@ -348,14 +539,86 @@ namespace River
             dof_handler.clear();
             triangulation.clear();
             hanging_node_constraints.clear();
+            system_matrix_float.clear();
             system_matrix.clear();
+            clear_factorization();
+            cell_buckets.clear();
+            laplace_matrix.clear();
+            clear_multigrid();
+            // far field is kept, because it can be reused with new triangulation(see solve_condensed())
+            refinment_tips.clear();
+            mesh_fingerprint = 0;
+            is_laplace_matrix_assembled = false;
+            is_system_reused = false;
             //solution.reinit(0);
         }
 
+        /*! \brief Keeps copy of current mesh and solution.
+            \details Should be called before clear(). Next run() will use it as initial guess of CG if warm_start is set.
+        */
+        void save_previous_solution();
+
+        /// Interpolates previous solution onto current mesh and uses it as initial guess of CG.
+        void interpolate_previous_solution();
+
         void setup_system();
         void assemble_system(const BoundaryConditions & boundary_conditions);
         void solve();
+
+        /*! \brief Solves system by iterative refinement with single precision inner CG.
+            \details Each outer step evaluates residual of current solution in double precision, solves correction equation
+            with single precision copy of system matrix and preconditioner to relative accuracy of 1e-4 and adds correction
+            to solution. Steps are repeated until residual is less than tollerance.
+            \return False if residual stops decreasing(e.g. single precision can't resolve badly conditioned system) or
+            preconditioner has no single precision version, then solve() finishes solution by double precision CG.
+        */
+        bool solve_mixed_precision();
+
+        /*! \brief Solves system by UMFPACK.
+            \details Matrix is compared with factorized one by fingerprint of its sparsity pattern and values, so while
+            triangulation and set of Dirichlet degrees of freedom are the same(boundary values change only right hand side),
+            only forward and backward substitutions are done.
+        */
+        void solve_direct();
+
+        /*! \brief Assembles right hand side and solves system without storing of system matrix.
+            \details Dirichlet values are lifted into right hand side, and CG with Jacobi preconditioner is applied
+            to Deal.II MatrixFreeOperators::LaplaceOperator.
+        */
+        void solve_matrix_free();
+
+        /*! \brief Solves system by CG with geometric multigrid V-cycle as preconditioner.
+            \details Levels are base mesh from Triangle and its static(and adaptive) refinments around tips, so number
+            of iterations doesn't grow with number of static refinments. Level matrices are assembled on all cells of level
+            with interface matrices at refinment edges, they are kept while triangulation and Dirichlet boundaries are the same.
+            Smoother is symmetric SOR, and coarse level is solved by CG with SSOR. Hanging nodes and Dirichlet values are
+            eliminated by constraints during assembly.
+            \exception River::Exception if triangulation doesn't limit level difference at vertices, i.e. Solver wasn't
+            constructed with preconditioner type 3.
+        */
+        void solve_multigrid();
+
+        /*! \brief Assembles and solves only zone around tips, far field enters system as Schur complement on interface of zone.
+            \details Far field is made of unrefined cells, which vertices are further than condensation_radius from all tips.
+            Its interior degrees of freedom are eliminated once(see FarField), and condensed system is reused at next growth steps
+            while far field cells are the same and no tip is closer than half of condensation_radius to interface.
+            Solution in far field is recovered from interface values by cached factorization.
+            \return False if there is no far field or zone, then whole system should be solved.
+        */
+        bool solve_condensed();
         double value(const River::Point &p) const;
+
+        /*! \brief Evaluates solution in many points at once.
+            \details Points are located with help of cell buckets index and last found cell as hint, then
+            shape functions are evaluated for all points of same cell together. No exceptions are thrown for
+            points outside of region, instead \p inside mask is set to false and value to zero.
+            \param[in] points Evaluation points.
+            \param[out] point_values Values of solution at \p points.
+            \param[out] inside True if point lies in region.
+            \note Doesn't change solver, so it can be called from several threads at once.
+        */
+        void values(const t_PointList &points, vector<double> &point_values, vector<bool> &inside) const;
+
         double valueSafe(const double x, const double y) const;
         void refine_grid();
         double max_cell_error();
@@ -390,9 +653,218 @@ namespace River
 
         AffineConstraints<double> hanging_node_constraints;
 
+        /// Mesh, dofs and solution of previous growth step. Used by warm start.
+        Triangulation<dim> previous_triangulation;
+        DoFHandler<dim> previous_dof_handler;
+        Vector<double> previous_solution;
+
+        /// Per thread FEValues objects used by parallel assembly(see assemble_system()).
+        struct AssemblyScratchData
+        {
+            AssemblyScratchData(
+                const FiniteElement<dim> &fe,
+                const dealii::Quadrature<dim> &quadrature,
+                const dealii::Quadrature<dim - 1> &face_quadrature);
+
+            AssemblyScratchData(const AssemblyScratchData &scratch_data);
+
+            FEValues<dim> fe_values;
+            FEFaceValues<dim> fe_face_values;
+        };
+
+        /// Cell matrix and right hand side produced by one worker, waiting to be copied into global system.
+        struct AssemblyCopyData
+        {
+            FullMatrix<double> cell_matrix;
+            Vector<double> cell_rhs;
+            vector<types::global_dof_index> local_dof_indices;
+            /// If false, only cell_rhs is assembled.
+            bool assemble_matrix = true;
+        };
+
+        void local_assemble_system(
+            const typename DoFHandler<dim>::active_cell_iterator &cell,
+            const t_BoundaryConditions &neuman_bd,
+            const bool assemble_matrix,
+            AssemblyScratchData &scratch_data,
+            AssemblyCopyData &copy_data) const;
+
+        void copy_local_to_global(const AssemblyCopyData &copy_data);
+
+        /*! \brief Splits region into uniform grid of buckets, each holds active cells which bounding box intersects it.
+            \details Is called by setup_system(), so buckets are ready before solution can be evaluated.
+        */
+        void build_cell_buckets();
+
+        /// Finds cell which contains point \p p. Search starts from \p cell, which is updated on success.
+        bool locate_point(const dealii::Point<dim> &p, typename DoFHandler<dim>::active_cell_iterator &cell, 
+            bool has_hint, dealii::Point<dim> &unit_point) const;
+
+        /// Returns stencil for \p integ, rebuilds cached one if parameters changed. Thread safe.
+        shared_ptr<const IntegrationStencil> get_integration_stencil(const IntegrationParams &integ);
+
+        /// Returns nested Fejer stencil of refinment \p level for \p integ. Thread safe.
+        shared_ptr<const IntegrationStencil> get_spectral_stencil(const IntegrationParams &integ, const unsigned level);
+
+        /// Integrates series parameters with stencil around tip.
+        vector<double> integrate_stencil(const IntegrationStencil &stencil, const Point &tip_coord, const double angle);
+
+        /// Cached integration stencils, see get_integration_stencil() and get_spectral_stencil().
+        shared_ptr<const IntegrationStencil> integration_stencil;
+        map<unsigned, shared_ptr<const IntegrationStencil>> spectral_stencils;
+        mutex integration_stencil_mutex;
+
+        /// Uniform grid of cells, used by values() for point location. Rebuilt after each setup of system.
+        vector<vector<typename DoFHandler<dim>::active_cell_iterator>> cell_buckets;
+        dealii::Point<dim> cell_buckets_origin;
+        double cell_bucket_size = 0;
+        unsigned cell_buckets_nx = 0, cell_buckets_ny = 0;
+
+        /// True if run() solves zone around tips by solve_condensed(), otherwise whole system is assembled.
+        bool is_condensation_used() const
+        {
+            return condensation_radius > 0 && !matrix_free && preconditioner_type != 3 && num_of_adaptive_refinments == 0;
+        }
+
+        /// Builds sparsity pattern of whole system and initializes system matrix with it.
+        void make_sparsity_pattern();
+
+        /*! \brief Far field condensed by solve_condensed().
+            \details Degrees of freedom of far field are numbered locally: interface ones(shared with zone cells) first, then
+            interior ones. They are matched with degrees of freedom of new triangulation by support points.
+        */
+        struct FarField
+        {
+            /// Sorted vertices coordinates of far field cells.
+            set<vector<double>> cell_keys;
+
+            /// Support points of far field degrees of freedom in local numbering.
+            vector<dealii::Point<dim>> dof_points;
+            unsigned n_interface = 0;
+
+            /// Conditions used by condensation, change of them invalidates it.
+            BoundaryConditions boundary_conditions;
+            double field_value = 0, condensation_radius = 0;
+
+            /// Schur complement of interior degrees of freedom and condensed right hand side on interface.
+            FullMatrix<double> schur_matrix;
+            Vector<double> schur_rhs;
+
+            /// Interior matrix with eliminated Dirichlet values, its coupling to interface and right hand side.
+            SparsityPattern interior_sparsity, coupling_sparsity;
+            SparseMatrix<double> interior_matrix, coupling_matrix;
+            Vector<double> interior_rhs;
+#ifdef DEAL_II_WITH_UMFPACK
+            SparseDirectUMFPACK interior_inverse;
+#endif
+            bool empty() const
+            {
+                return dof_points.empty();
+            }
+
+            /// Sorted coordinates of vertices of \p cell, they don't depend on numbering of cells.
+            template <typename CellIterator>
+            static vector<double> cell_key(const CellIterator &cell)
+            {
+                array<dealii::Point<dim>, GeometryInfo<dim>::vertices_per_cell> vertices;
+                for (unsigned v = 0; v < vertices.size(); ++v)
+                    vertices[v] = cell->vertex(v);
+                sort(vertices.begin(), vertices.end(), [](const dealii::Point<dim> &a, const dealii::Point<dim> &b)
+                {
+                    return a[0] < b[0] || (a[0] == b[0] && a[1] < b[1]);
+                });
+
+                vector<double> key;
+                for (const auto &vertex: vertices)
+                    key.insert(key.end(), {vertex[0], vertex[1]});
+                return key;
+            }
+
+            void clear();
+        };
+
+        /*! \brief Finds cached far field cells and degrees of freedom in current triangulation.
+            \param[out] far_dofs Current indices of far field degrees of freedom in local numbering.
+            \param[out] is_far_cell Mask of far field cells by active cell index.
+            \return False if far field should be condensed again.
+        */
+        bool match_far_field(const vector<dealii::Point<dim>> &support_points,
+            vector<types::global_dof_index> &far_dofs, vector<bool> &is_far_cell) const;
+
+        /// Selects far field cells around refinment_tips and condenses them, returns false if there is no far field or zone.
+        bool condense_far_field(const vector<dealii::Point<dim>> &support_points,
+            vector<types::global_dof_index> &far_dofs, vector<bool> &is_far_cell);
+
+        /// Solves interior far field system with cached factorization(or CG with SSOR if Deal.II is built without UMFPACK).
+        void solve_far_field_interior(Vector<double> &x, const Vector<double> &b) const;
+
+        /// Tips used by last static refinment, solve_condensed() keeps zone around them.
+        t_PointList refinment_tips;
+
+        FarField far_field;
+
+        /// Matrix free solution for fixed FE_Q degree, see solve_matrix_free().
+        template <int fe_degree>
+        void solve_matrix_free_degree();
+
+        /// Distributes level dofs, builds transfer and assembles level matrices, see solve_multigrid().
+        void setup_multigrid(const set<types::boundary_id> &dirichlet_boundary_ids);
+
+        /// Assembles level and interface matrices.
+        void assemble_multigrid();
+
+        /// Releases factorization of solve_direct().
+        void clear_factorization()
+        {
+#ifdef DEAL_II_WITH_UMFPACK
+            direct_factorization.clear();
+#endif
+            factorization_fingerprint = 0;
+        }
+
+        /// Releases level matrices, so they are rebuilt at next solve_multigrid().
+        void clear_multigrid()
+        {
+            for (auto level = mg_matrices.min_level(); level <= mg_matrices.max_level(); ++level)
+                mg_matrices[level].clear();
+            for (auto level = mg_interface_matrices.min_level(); level <= mg_interface_matrices.max_level(); ++level)
+                mg_interface_matrices[level].clear();
+            is_multigrid_ready = false;
+        }
+
+        /// Level dofs on refinment edges and Dirichlet boundaries.
+        MGConstrainedDoFs mg_constrained_dofs;
+        MGTransferPrebuilt<Vector<double>> mg_transfer;
+        MGLevelObject<SparsityPattern> mg_sparsity_patterns, mg_interface_sparsity_patterns;
+        MGLevelObject<SparseMatrix<double>> mg_matrices, mg_interface_matrices;
+        /// Dirichlet boundaries of level matrices.
+        set<types::boundary_id> mg_dirichlet_boundary_ids;
+        bool is_multigrid_ready = false;
+
         SparsityPattern sparsity_pattern;
+        /// Pattern of zone system of solve_condensed().
+        SparsityPattern zone_sparsity_pattern;
         SparseMatrix<double> system_matrix;
 
+        /// Single precision copy of system matrix used by solve_mixed_precision().
+        SparseMatrix<float> system_matrix_float;
+
+#ifdef DEAL_II_WITH_UMFPACK
+        /// Factorization of system matrix used by solve_direct().
+        SparseDirectUMFPACK direct_factorization;
+#endif
+        /// Fingerprint of factorized matrix, zero if there is no factorization.
+        uint64_t factorization_fingerprint = 0;
+
+        /*! \brief Fingerprint of mesh, tips and static refinment passed to OpenMeshIfChanged().
+            \details Zero if triangulation was created or changed otherwise, then nothing is cached between runs.
+        */
+        uint64_t mesh_fingerprint = 0;
+
+        /// Stiffness matrix with condensed hanging nodes and without boundary conditions, kept while triangulation is the same.
+        SparseMatrix<double> laplace_matrix;
+        bool is_laplace_matrix_assembled = false;
+
         /// Holds solution of problem.
         Vector<double> solution;
 
@@ -18,6 +18,8 @@
 #include <algorithm>
 #include <fstream>
 #include <cmath>
+#include <cstring>
+#include <limits>
 ///\endcond
 
 namespace tethex {
@@ -735,54 +737,16 @@ namespace tethex {
       //holes
       holes = msh.get_holes();
 
-      //PhysPoints
-      points.reserve(msh.get_n_points());
-      for(unsigned i = 0; i < msh.get_n_points(); ++i)
-      {
-        points.push_back(
-          new PhysPoint(msh.get_point(i).get_vertex(0), msh.get_point(i).get_material_id()));
-      }
-
-      //Lines
-      lines.reserve(msh.get_n_lines());
-      for(unsigned i = 0; i < msh.get_n_lines(); ++i)
-      {
-        lines.push_back(
-          new Line(
-            msh.get_line(i).get_vertex(0), 
-            msh.get_line(i).get_vertex(1), 
-            msh.get_line(i).get_material_id()));
-      }
-
-      //Triangles
-      triangles.reserve(msh.get_n_triangles());
-      for(unsigned i = 0; i < msh.get_n_triangles(); ++i)
-      {
-        triangles.push_back(
-          new Triangle(
-            msh.get_triangle(i).get_vertex(0), 
-            msh.get_triangle(i).get_vertex(1), 
-            msh.get_triangle(i).get_vertex(2), 
-            msh.get_triangle(i).get_material_id()));
-      }
-
-      //Quadrangles
-      quadrangles.reserve(msh.get_n_quadrangles());
-      for(unsigned i = 0; i < msh.get_n_quadrangles(); ++i)
-      {
-        quadrangles.push_back(
-          new Quadrangle(
-            msh.get_quadrangle(i).get_vertex(0), 
-            msh.get_quadrangle(i).get_vertex(1), 
-            msh.get_quadrangle(i).get_vertex(2), 
-            msh.get_quadrangle(i).get_vertex(3), 
-            msh.get_quadrangle(i).get_material_id()));
-      }
+      //Elements
+      copy_elements(msh);
     }
 
 
     Mesh& Mesh::operator =(const Mesh& msh)
     {
+      if (this == &msh)
+        return *this;
+
       clean();
       
       n_converted_quadrangles = msh.get_n_converted_quadrangles();
@@ -794,61 +758,21 @@ namespace tethex {
       //Holes
       holes = msh.get_holes();
 
-      //PhysPoints
-      points.reserve(msh.get_n_points());
-      for(unsigned i = 0; i < msh.get_n_points(); ++i)
-      {
-        points.push_back(
-          new PhysPoint(msh.get_point(i).get_vertex(0), msh.get_point(i).get_material_id()));
-      }
-
-      //Lines
-      lines.reserve(msh.get_n_lines());
-      for(unsigned i = 0; i < msh.get_n_lines(); ++i)
-      {
-        lines.push_back(
-          new Line(
-            msh.get_line(i).get_vertex(0), 
-            msh.get_line(i).get_vertex(1), 
-            msh.get_line(i).get_material_id()));
-      }
-
-      //Triangles
-      triangles.reserve(msh.get_n_triangles());
-      for(unsigned i = 0; i < msh.get_n_triangles(); ++i)
-      {
-        triangles.push_back(
-          new Triangle(
-            msh.get_triangle(i).get_vertex(0), 
-            msh.get_triangle(i).get_vertex(1), 
-            msh.get_triangle(i).get_vertex(2), 
-            msh.get_triangle(i).get_material_id()));
-      }
-
-      //Quadrangles
-      quadrangles.reserve(msh.get_n_quadrangles());
-      for(unsigned i = 0; i < msh.get_n_quadrangles(); ++i)
-      {
-        quadrangles.push_back(
-          new Quadrangle(
-            msh.get_quadrangle(i).get_vertex(0), 
-            msh.get_quadrangle(i).get_vertex(1), 
-            msh.get_quadrangle(i).get_vertex(2), 
-            msh.get_quadrangle(i).get_vertex(3), 
-            msh.get_quadrangle(i).get_material_id()));
-      }
+      //Elements
+      copy_elements(msh);
 
       return *this;
     }
 
-    Mesh::Mesh(const River::Boundary &boundary, const River::t_PointList &boundary_holes)
+    Mesh::Mesh(const River::Boundary &boundary, const River::t_PointList &boundary_holes):
+      n_converted_quadrangles(0)
     {
         vertices.reserve(boundary.vertices.size());
         lines.reserve(boundary.lines.size());
         for(const auto& vertice: boundary.vertices)
             vertices.push_back(vertice);
         for(const auto& line: boundary.lines)
-            lines.push_back(new tethex::Line(line));
+            add_line(tethex::Line(line));
 
 
         holes.reserve(boundary_holes.size());
@@ -856,41 +780,87 @@ namespace tethex {
             holes.push_back(hole);
     }
 
+    /**
+     * Rebuilds list of pointers to elements of storage.
+     */
+    template<class Element>
+    void rebuild_pointers(deque<Element> &store, vector<MeshElement *> &elements)
+    {
+      elements.resize(store.size());
+      size_t i = 0;
+      for (auto &element: store)
+        elements[i++] = &element;
+    }
+
+    void Mesh::copy_elements(const Mesh &msh)
+    {
+      //storage is copied chunk by chunk, so no element is allocated separately
+      point_store = msh.point_store;
+      line_store = msh.line_store;
+      edge_store = msh.edge_store;
+      triangle_store = msh.triangle_store;
+      quadrangle_store = msh.quadrangle_store;
+
+      rebuild_pointers(point_store, points);
+      rebuild_pointers(line_store, lines);
+      rebuild_pointers(edge_store, edges);
+      rebuild_pointers(triangle_store, triangles);
+      rebuild_pointers(quadrangle_store, quadrangles);
+    }
+
 
       void Mesh::set_points(const vector<MeshElement *> &pointsVal)
       {
-        for (size_t i = 0; i < points.size(); ++i)
-          delete points.at(i);
-
-        points = pointsVal;
+        point_store.clear();
+        points.clear();
+        for (auto p: pointsVal)
+        {
+          add_point(PhysPoint(p->get_vertex(0), p->get_material_id()));
+          delete p;
+        }
       }
 
 
       void Mesh::set_lines(const vector<MeshElement *> &linesVal)
       { 
-        for (size_t i = 0; i < lines.size(); ++i)
-          delete lines.at(i);
-        lines = linesVal;
+        line_store.clear();
+        lines.clear();
+        append_lines(linesVal);
+      }
+
+
+      void Mesh::append_lines(const vector<MeshElement *> &lines_val)
+      {
+        for (auto l: lines_val)
+        {
+          add_line(Line(l->get_vertex(0), l->get_vertex(1), l->get_material_id()));
+          delete l;
+        }
       }
 
 
       void Mesh::set_triangles(const vector<MeshElement *> &trianglesVal)
       {
-        for (size_t i = 0; i < triangles.size(); ++i)
-          delete triangles[i];
+        triangle_store.clear();
         triangles.clear();
-
-        triangles = trianglesVal;
+        for (auto t: trianglesVal)
+        {
+          add_triangle(Triangle(t->get_vertex(0), t->get_vertex(1), t->get_vertex(2), t->get_material_id()));
+          delete t;
+        }
       }
     
     
       void Mesh::set_quadrangles(const vector<MeshElement *> &quadranglesVal)
       {
-        for (size_t i = 0; i < quadrangles.size(); ++i)
-          delete quadrangles[i];
+        quadrangle_store.clear();
         quadrangles.clear();
-
-        quadrangles = quadranglesVal;
+        for (auto q: quadranglesVal)
+        {
+          add_quadrangle(Quadrangle(
+            q->get_vertex(0), q->get_vertex(1), q->get_vertex(2), q->get_vertex(3), q->get_material_id()));
+          delete q;
+        }
       }
 
 
@@ -899,21 +869,16 @@ namespace tethex {
     {
       vertices.clear();
       holes.clear();
-      for (size_t i = 0; i < points.size(); ++i)
-        delete points[i];
       points.clear();
-      for (size_t i = 0; i < lines.size(); ++i)
-        delete lines[i];
+      point_store.clear();
       lines.clear();
-      for (size_t i = 0; i < edges.size(); ++i)
-        delete edges[i];
+      line_store.clear();
       edges.clear();
-      for (size_t i = 0; i < triangles.size(); ++i)
-        delete triangles[i];
+      edge_store.clear();
       triangles.clear();
-      for (size_t i = 0; i < quadrangles.size(); ++i)
-        delete quadrangles[i];
+      triangle_store.clear();
       quadrangles.clear();
+      quadrangle_store.clear();
 
       physical_names.clear();
 
@@ -1066,16 +1031,16 @@ namespace tethex {
               switch (el_type)
               {
               case 15: // 1-node point
-                points.push_back(new PhysPoint(nodes, phys_domain));
+                add_point(PhysPoint(nodes, phys_domain));
                 break;
               case 1: // 2-nodes line
-                lines.push_back(new Line(nodes, phys_domain));
+                add_line(Line(nodes, phys_domain));
                 break;
               case 2: // 3-nodes triangle
-                triangles.push_back(new Triangle(nodes, phys_domain));
+                add_triangle(Triangle(nodes, phys_domain));
                 break;
               case 3: // 4-nodes quadrangle
-                quadrangles.push_back(new Quadrangle(nodes, phys_domain));
+                add_quadrangle(Quadrangle(nodes, phys_domain));
                 break;
               default:
                 require(false, "Unknown type of the Gmsh's element (" +
@@ -1183,9 +1148,8 @@ namespace tethex {
       // because after adding new vertices they need to be redefined
       redefine_lines(incidence_matrix, n_old_vertices);
 
-      for (size_t i = 0; i < edges.size(); ++i)
-        delete edges[i];
       edges.clear();
+      edge_store.clear();
     }
 
     void Mesh::convert_triangles(const IncidenceMatrix &incidence_matrix,
@@ -1259,8 +1223,8 @@ namespace tethex {
     //        swap(quadrangle_vertices[1], quadrangle_vertices[3]);
 
           // now we are ready to generate quadrangle
-          quadrangles.push_back(new Quadrangle(quadrangle_vertices,
-                                               triangles[tri]->get_material_id()));
+          add_quadrangle(Quadrangle(quadrangle_vertices,
+                                    triangles[tri]->get_material_id()));
 
         } // for every vertex we have one quadrangle
       } // triangles
@@ -1307,8 +1271,8 @@ namespace tethex {
 
         // we change existing line and add new line at the end of list
         lines[line]->set_vertex(1, n_old_vertices + edge); // changing existing line
-        lines.push_back(new Line(n_old_vertices + edge, ver2,
-                                 lines[line]->get_material_id())); // add new line
+        add_line(Line(n_old_vertices + edge, ver2,
+                      lines[line]->get_material_id())); // add new line
       }
 
       require(n_old_lines * 2 == (int)lines.size(),
@@ -1329,7 +1293,10 @@ namespace tethex {
 
       // allocate memory for edges
       if (initialize_edges)
-        edges.resize(n_edges);
+      {
+        edge_store.assign(n_edges, Line());
+        rebuild_pointers(edge_store, edges);
+      }
 
       // look through all cells of the mesh
       for (size_t cell = 0; cell < cells.size(); ++cell)
@@ -1348,12 +1315,9 @@ namespace tethex {
               cells[cell]->set_edge(lne, gne);
               // initialize edge
               if (initialize_edges)
-              {
-                delete edges[gne];
-                edges[gne] = new Line(min(ii, jj),
-                                      max(ii, jj),
-                                      cells[cell]->get_material_id());
-              }
+                edge_store[gne] = Line(min(ii, jj),
+                                       max(ii, jj),
+                                       cells[cell]->get_material_id());
               // increase local number of edge
               ++lne;
             }
@@ -1415,6 +1379,311 @@ namespace tethex {
       out.close();
     }
 
+    void FlatMesh::clear()
+    {
+      vertices.clear();
+      quadrangles.clear();
+      quadrangle_material_ids.clear();
+      lines.clear();
+      line_material_ids.clear();
+    }
+
+    uint64_t FlatMesh::fingerprint() const
+    {
+      uint64_t hash = 14695981039346656037ull;
+      auto add = [&hash](const void *data, size_t n_bytes)
+      {
+        auto bytes = static_cast<const unsigned char*>(data);
+        for (size_t i = 0; i < n_bytes; ++i)
+          hash = (hash ^ bytes[i]) * 1099511628211ull;
+      };
+      //sizes separate arrays, so different splits of same bytes give different hashes
+      auto add_vector = [&add](const auto &v)
+      {
+        const uint64_t size = v.size();
+        add(&size, sizeof(size));
+        add(v.data(), v.size() * sizeof(v[0]));
+      };
+
+      add_vector(vertices);
+      add_vector(quadrangles);
+      add_vector(quadrangle_material_ids);
+      add_vector(lines);
+      add_vector(line_material_ids);
+
+      return hash;
+    }
+
+    void FlatMesh::write(const string &file) const
+    {
+      ofstream out(file.c_str());
+      require(out, "File " + file + " cannot be opened for writing!");
+
+      out.setf(ios::scientific);
+      out.precision(16);
+
+      out << "$MeshFormat\n2.2 0 8\n$EndMeshFormat\n";
+
+      out << "$Nodes\n" << get_n_vertices() << "\n";
+      for (size_t ver = 0; ver < get_n_vertices(); ++ver)
+        out << ver + 1 << " " << vertices[2 * ver] << " " << vertices[2 * ver + 1] << " " << 0. << " \n";
+
+      out << "$EndNodes\n$Elements\n" << get_n_lines() + get_n_quadrangles() << "\n";
+
+      size_t serial_number = 0;
+      for (size_t el = 0; el < get_n_lines(); ++el)
+        out << ++serial_number << " " << Line::gmsh_el_type << " 2 "
+            << line_material_ids[el] << " " << line_material_ids[el] << " "
+            << lines[2 * el] + 1 << " " << lines[2 * el + 1] + 1 << " \n";
+
+      //Gmsh numerates quadrangle vertices counterclockwise, deal.II - lexicographically
+      for (size_t el = 0; el < get_n_quadrangles(); ++el)
+        out << ++serial_number << " " << Quadrangle::gmsh_el_type << " 2 "
+            << quadrangle_material_ids[el] << " " << quadrangle_material_ids[el] << " "
+            << quadrangles[4 * el] + 1 << " " << quadrangles[4 * el + 1] + 1 << " "
+            << quadrangles[4 * el + 3] + 1 << " " << quadrangles[4 * el + 2] + 1 << " \n";
+
+      out << "$EndElements\n";
+    }
+
+    void FlatMesh::write(const string &file, MshFormat format) const
+    {
+      switch (format)
+      {
+        case MSH_NONE:
+          break;
+        case MSH_22_ASCII:
+          write(file);
+          break;
+        case MSH_22_BINARY:
+          write_binary(file);
+          break;
+        case MSH_41_BINARY:
+          write_v41_binary(file);
+          break;
+        default:
+          require(false, "Unknown mesh file format: " + d2s(format));
+      }
+    }
+
+    /**
+     * Writes raw bytes of value into binary stream.
+     */
+    template<class T>
+    inline void write_raw(ostream &out, const T &value)
+    {
+      out.write(reinterpret_cast<const char*>(&value), sizeof(T));
+    }
+
+    void FlatMesh::write_binary(const string &file) const
+    {
+      ofstream out(file.c_str(), ios::binary);
+      require(out, "File " + file + " cannot be opened for writing!");
+
+      out << "$MeshFormat\n2.2 1 8\n";
+      write_raw(out, int(1));
+      out << "\n$EndMeshFormat\n";
+
+      //node number and three coordinates of each node are packed into one buffer
+      const size_t node_size = sizeof(int) + 3 * sizeof(double);
+      vector<char> buffer(get_n_vertices() * node_size);
+      for (size_t ver = 0; ver < get_n_vertices(); ++ver)
+      {
+        int number = ver + 1;
+        double coords[3] = {vertices[2 * ver], vertices[2 * ver + 1], 0.};
+        memcpy(&buffer[ver * node_size], &number, sizeof(int));
+        memcpy(&buffer[ver * node_size + sizeof(int)], coords, sizeof(coords));
+      }
+      out << "$Nodes\n" << get_n_vertices() << "\n";
+      out.write(buffer.data(), buffer.size());
+      out << "\n$EndNodes\n";
+
+      out << "$Elements\n" << get_n_lines() + get_n_quadrangles() << "\n";
+
+      //element header: type, number of elements, number of tags
+      //each element: number, physical and elementary tags, vertices
+      int serial_number = 0;
+      if (get_n_lines())
+      {
+        int header[3] = {Line::gmsh_el_type, (int)get_n_lines(), 2};
+        out.write(reinterpret_cast<const char*>(header), sizeof(header));
+        vector<int> data(5 * get_n_lines());
+        for (size_t el = 0; el < get_n_lines(); ++el)
+        {
+          data[5 * el] = ++serial_number;
+          data[5 * el + 1] = data[5 * el + 2] = line_material_ids[el];
+          data[5 * el + 3] = lines[2 * el] + 1;
+          data[5 * el + 4] = lines[2 * el + 1] + 1;
+        }
+        out.write(reinterpret_cast<const char*>(data.data()), data.size() * sizeof(int));
+      }
+      if (get_n_quadrangles())
+      {
+        int header[3] = {Quadrangle::gmsh_el_type, (int)get_n_quadrangles(), 2};
+        out.write(reinterpret_cast<const char*>(header), sizeof(header));
+        vector<int> data(7 * get_n_quadrangles());
+        for (size_t el = 0; el < get_n_quadrangles(); ++el)
+        {
+          //Gmsh numerates quadrangle vertices counterclockwise, deal.II - lexicographically
+          data[7 * el] = ++serial_number;
+          data[7 * el + 1] = data[7 * el + 2] = quadrangle_material_ids[el];
+          data[7 * el + 3] = quadrangles[4 * el] + 1;
+          data[7 * el + 4] = quadrangles[4 * el + 1] + 1;
+          data[7 * el + 5] = quadrangles[4 * el + 3] + 1;
+          data[7 * el + 6] = quadrangles[4 * el + 2] + 1;
+        }
+        out.write(reinterpret_cast<const char*>(data.data()), data.size() * sizeof(int));
+      }
+      out << "\n$EndElements\n";
+    }
+
+    void FlatMesh::write_v41_binary(const string &file) const
+    {
+      ofstream out(file.c_str(), ios::binary);
+      require(out, "File " + file + " cannot be opened for writing!");
+
+      out << "$MeshFormat\n4.1 1 8\n";
+      write_raw(out, int(1));
+      out << "\n$EndMeshFormat\n";
+
+      //each material id of lines is curve entity, and of quadrangles - surface entity,
+      //physical tag of entity is material id itself
+      auto group_by_material = [](const vector<int> &ids, vector<int> &materials, vector<size_t> &order)
+      {
+        materials = ids;
+        sort(materials.begin(), materials.end());
+        materials.erase(unique(materials.begin(), materials.end()), materials.end());
+        order.resize(ids.size());
+        for (size_t i = 0; i < ids.size(); ++i)
+          order[i] = i;
+        stable_sort(order.begin(), order.end(), [&ids](size_t a, size_t b){ return ids[a] < ids[b]; });
+      };
+      vector<int> curve_materials, surface_materials;
+      vector<size_t> lines_order, quadrangles_order;
+      group_by_material(line_material_ids, curve_materials, lines_order);
+      group_by_material(quadrangle_material_ids, surface_materials, quadrangles_order);
+
+      //inner lines(negative material id) would get negative physical tag, which means reversed orientation
+      //in Gmsh 4.1, so they are skipped: faces without lines are interior anyway
+      const auto n_inner_lines = lower_bound(curve_materials.begin(), curve_materials.end(), 0) - curve_materials.begin();
+      curve_materials.erase(curve_materials.begin(), curve_materials.begin() + n_inner_lines);
+      lines_order.erase(lines_order.begin(), find_if(lines_order.begin(), lines_order.end(), 
+        [this](size_t line){ return line_material_ids[line] >= 0; }));
+
+      auto write_bounding_box = [this](const vector<unsigned> &elements, const vector<int> &ids, 
+        size_t n_el_vertices, int material)
+      {
+        double box[6] = {
+          numeric_limits<double>::max(), numeric_limits<double>::max(), 0., 
+          numeric_limits<double>::lowest(), numeric_limits<double>::lowest(), 0.};
+        for (size_t el = 0; el < ids.size(); ++el)
+          if (ids[el] == material)
+            for (size_t k = 0; k < n_el_vertices; ++k)
+            {
+              auto v = elements[n_el_vertices * el + k];
+              box[0] = min(box[0], vertices[2 * v]);
+              box[1] = min(box[1], vertices[2 * v + 1]);
+              box[3] = max(box[3], vertices[2 * v]);
+              box[4] = max(box[4], vertices[2 * v + 1]);
+            }
+        return vector<double>(box, box + 6);
+      };
+
+      out << "$Entities\n";
+      write_raw(out, size_t(0));
+      write_raw(out, curve_materials.size());
+      write_raw(out, surface_materials.size());
+      write_raw(out, size_t(0));
+      for (size_t c = 0; c < curve_materials.size(); ++c)
+      {
+        write_raw(out, int(c + 1));
+        auto box = write_bounding_box(lines, line_material_ids, 2, curve_materials[c]);
+        out.write(reinterpret_cast<const char*>(box.data()), 6 * sizeof(double));
+        write_raw(out, size_t(1));
+        write_raw(out, curve_materials[c]);
+        write_raw(out, size_t(0));
+      }
+      for (size_t s = 0; s < surface_materials.size(); ++s)
+      {
+        write_raw(out, int(s + 1));
+        auto box = write_bounding_box(quadrangles, quadrangle_material_ids, 4, surface_materials[s]);
+        out.write(reinterpret_cast<const char*>(box.data()), 6 * sizeof(double));
+        write_raw(out, size_t(1));
+        write_raw(out, surface_materials[s]);
+        write_raw(out, size_t(0));
+      }
+      out << "\n$EndEntities\n";
+
+      //all nodes are in one block of the first surface(or curve)
+      const size_t n_vertices = get_n_vertices();
+      out << "$Nodes\n";
+      write_raw(out, size_t(n_vertices ? 1 : 0));
+      write_raw(out, n_vertices);
+      write_raw(out, size_t(n_vertices ? 1 : 0));
+      write_raw(out, n_vertices);
+      if (n_vertices)
+      {
+        write_raw(out, int(surface_materials.empty() ? 1 : 2));
+        write_raw(out, int(1));
+        write_raw(out, int(0));
+        write_raw(out, n_vertices);
+        vector<size_t> tags(n_vertices);
+        for (size_t ver = 0; ver < n_vertices; ++ver)
+          tags[ver] = ver + 1;
+        out.write(reinterpret_cast<const char*>(tags.data()), tags.size() * sizeof(size_t));
+        vector<double> coords(3 * n_vertices);
+        for (size_t ver = 0; ver < n_vertices; ++ver)
+        {
+          coords[3 * ver] = vertices[2 * ver];
+          coords[3 * ver + 1] = vertices[2 * ver + 1];
+          coords[3 * ver + 2] = 0.;
+        }
+        out.write(reinterpret_cast<const char*>(coords.data()), coords.size() * sizeof(double));
+      }
+      out << "\n$EndNodes\n";
+
+      //one block of elements for each entity
+      const size_t n_elements = lines_order.size() + get_n_quadrangles();
+      out << "$Elements\n";
+      write_raw(out, curve_materials.size() + surface_materials.size());
+      write_raw(out, n_elements);
+      write_raw(out, size_t(n_elements ? 1 : 0));
+      write_raw(out, n_elements);
+
+      size_t serial_number = 0;
+      auto write_blocks = [&](int dim, int el_type, const vector<int> &materials, const vector<int> &ids,
+        const vector<size_t> &order, const vector<unsigned> &elements, const vector<int> &node_order)
+      {
+        size_t begin = 0;
+        for (size_t entity = 0; entity < materials.size(); ++entity)
+        {
+          size_t end = begin;
+          while (end < order.size() && ids[order[end]] == materials[entity])
+            ++end;
+
+          write_raw(out, dim);
+          write_raw(out, int(entity + 1));
+          write_raw(out, el_type);
+          write_raw(out, end - begin);
+          const size_t n_el_vertices = node_order.size();
+          vector<size_t> data((end - begin) * (n_el_vertices + 1));
+          for (size_t i = begin; i < end; ++i)
+          {
+            auto row = (i - begin) * (n_el_vertices + 1);
+            data[row] = ++serial_number;
+            for (size_t k = 0; k < n_el_vertices; ++k)
+              data[row + 1 + k] = elements[n_el_vertices * order[i] + node_order[k]] + 1;
+          }
+          out.write(reinterpret_cast<const char*>(data.data()), data.size() * sizeof(size_t));
+          begin = end;
+        }
+      };
+      write_blocks(1, Line::gmsh_el_type, curve_materials, line_material_ids, lines_order, lines, {0, 1});
+      //Gmsh numerates quadrangle vertices counterclockwise, deal.II - lexicographically
+      write_blocks(2, Quadrangle::gmsh_el_type, surface_materials, quadrangle_material_ids, quadrangles_order, quadrangles, {0, 1, 3, 2});
+      out << "\n$EndElements\n";
+    }
+
     void Mesh::info(ostream &out) const
     {
       out << "\nvertices       : " << vertices.size()
@@ -34,6 +34,7 @@
 #include <stdexcept>
 #include <string>
 #include <vector>
+#include <deque>
 #include <cstdlib>
 ///\endcond
 
@@ -247,6 +248,78 @@ namespace tethex
     // MeshElement
     //
     //-------------------------------------------------------
+    //-------------------------------------------------------
+    //
+    // ElementIndices
+    //
+    //-------------------------------------------------------
+    /**
+     * Fixed capacity list of global numbers of element vertices or edges.
+     * Numbers are kept inside of element itself,
+     * so creating or copying of mesh element doesn't allocate memory.
+     */
+    class ElementIndices
+    {
+    public:
+        /**
+        * Maximal number of indices - quadrangle has 4 vertices and 4 edges.
+        */
+        static const int max_size = 4;
+
+        /**
+        * Constructor
+        * @param n - number of indices
+        * @param value - initial value of each index
+        */
+        inline ElementIndices(int n = 0, int value = 0)
+        {
+            resize(n, value);
+        }
+
+        inline size_t size() const
+        {
+            return n;
+        }
+
+        inline void resize(int n_val, int value = 0)
+        {
+            expect(n_val >= 0 && n_val <= max_size,
+                "Number of indices (" + d2s(n_val) + ") exceeds maximal size " + d2s(max_size));
+            n = n_val;
+            for (int i = 0; i < n; ++i)
+                data[i] = value;
+        }
+
+        inline int &operator[](int i)
+        {
+            return data[i];
+        }
+
+        inline int operator[](int i) const
+        {
+            return data[i];
+        }
+
+        inline int at(int i) const
+        {
+            if (i < 0 || i >= n)
+                throw out_of_range("ElementIndices: index " + d2s(i) + " is out of range [0, " + d2s(n) + ")");
+            return data[i];
+        }
+
+        inline ElementIndices &operator=(const vector<int> &values)
+        {
+            resize(values.size());
+            for (int i = 0; i < n; ++i)
+                data[i] = values[i];
+            return *this;
+        }
+
+    private:
+        int n = 0;
+        int data[max_size];
+    };
+
     /**
      * This class implements the most part of functionality of
      * all elements of mesh: triangles, tetrahedra, quadrangles, hexahedra, etc.
@@ -379,7 +452,7 @@ namespace tethex
         /**
         * Vertices (i.e. their global numbers) describing the element
         */
-        vector<int> vertices;
+        ElementIndices vertices;
 
         /**
         * The number of edges describing the element.
@@ -392,7 +465,7 @@ namespace tethex
         * Edges (i.e. their global numbers) describing the element
         * It's not always used.
         */
-        vector<int> edges;
+        ElementIndices edges;
 
         /**
         * ID of the physical domain where the element takes place.
@@ -759,6 +832,9 @@ namespace tethex
     //-------------------------------------------------------
     /**
      * Main class that stores all data during program execution.
+     * Elements are kept by value in contiguous chunked storage of each element type,
+     * and vectors of pointers (see get_lines(), get_quadrangles() etc.) refer to it.
+     * So mesh elements are not allocated one by one, and copy of the mesh copies whole storage.
      */
     class Mesh
     {
@@ -1015,37 +1091,72 @@ namespace tethex
             }
 
             /**
-            * Set the physical points
+            * Set the physical points.
+            * Mesh takes ownership: points are copied into mesh storage and deleted.
             * @param pointsVal - the vector of points
             */
             void set_points(const vector<MeshElement *> &pointsVal);
 
             /**
-            * Set the physical lines
+            * Set the physical lines.
+            * Mesh takes ownership: lines are copied into mesh storage and deleted.
             * @param linesVal - the vector of lines
             */
             void set_lines(const vector<MeshElement *> &linesVal);
 
             /**
-            * Append the physical lines
+            * Append the physical lines.
+            * Mesh takes ownership: lines are copied into mesh storage and deleted.
             * @param lines_val - new vector of lines
             */
-            inline void append_lines(const vector<MeshElement *> &lines_val)
-            {
-                lines.insert(end(lines), lines_val.begin(), lines_val.end());
-            }
+            void append_lines(const vector<MeshElement *> &lines_val);
+
             /**
-            * Set the mesh triangles
+            * Set the mesh triangles.
+            * Mesh takes ownership: triangles are copied into mesh storage and deleted.
             * @param trianglesVal - the vector of triangles
             */
             void set_triangles(const vector<MeshElement *> &trianglesVal);
 
             /**
-            * Set the mesh quadrangles
+            * Set the mesh quadrangles.
+            * Mesh takes ownership: quadrangles are copied into mesh storage and deleted.
             * @param quadranglesVal - the vector of quadrangles
             */
             void set_quadrangles(const vector<MeshElement *> &quadranglesVal);
 
+            /**
+            * Add copy of physical point into mesh storage.
+            */
+            inline void add_point(const PhysPoint &point)
+            {
+                add_element(point_store, points, point);
+            }
+
+            /**
+            * Add copy of physical line into mesh storage.
+            */
+            inline void add_line(const Line &line)
+            {
+                add_element(line_store, lines, line);
+            }
+
+            /**
+            * Add copy of triangle into mesh storage.
+            */
+            inline void add_triangle(const Triangle &triangle)
+            {
+                add_element(triangle_store, triangles, triangle);
+            }
+
+            /**
+            * Add copy of quadrangle into mesh storage.
+            */
+            inline void add_quadrangle(const Quadrangle &quadrangle)
+            {
+                add_element(quadrangle_store, quadrangles, quadrangle);
+            }
+
             /**
             * Free the memory to read again, for example
             */
@@ -1088,6 +1199,35 @@ namespace tethex
             */
             vector<MeshElement *> quadrangles;
 
+            ///@{
+            /**
+            * Storage of mesh elements.
+            * Deque keeps elements in contiguous chunks and doesn't move them on insertion,
+            * so pointers from points, lines, edges, triangles and quadrangles stay valid.
+            * I-th pointer always refers to i-th element of storage.
+            */
+            deque<PhysPoint> point_store;
+            deque<Line> line_store;
+            deque<Line> edge_store;
+            deque<Triangle> triangle_store;
+            deque<Quadrangle> quadrangle_store;
+            ///@}
+
+            /**
+            * Add copy of element into storage and its pointer into list of elements.
+            */
+            template<class Element>
+            inline void add_element(deque<Element> &store, vector<MeshElement *> &elements, const Element &element)
+            {
+                store.push_back(element);
+                elements.push_back(&store.back());
+            }
+
+            /**
+            * Copy elements of other mesh storage and rebuild lists of pointers.
+            */
+            void copy_elements(const Mesh &msh);
+
             ///vector map
             typedef vector<map<int, int>> VectorMap;
 
@@ -1193,6 +1333,79 @@ namespace tethex
             void convert_quadrangles();
     };
 
+    //-------------------------------------------------------
+    //
+    // FlatMesh
+    //
+    //-------------------------------------------------------
+    /**
+     * Formats of mesh file.
+     */
+    enum MshFormat
+    {
+        MSH_NONE = 0,     ///< mesh isn't written
+        MSH_22_ASCII,     ///< Gmsh 2.2 text
+        MSH_22_BINARY,    ///< Gmsh 2.2 binary
+        MSH_41_BINARY     ///< Gmsh 4.1 binary
+    };
+
+    /**
+     * Quadrangular mesh stored in flat arrays.
+     * It is built straight from Triangle output(see River::Triangle::generate_flat_quadrangular_mesh)
+     * without per element allocations, and its layout follows input of
+     * dealii::Triangulation::create_triangulation.
+     */
+    struct FlatMesh
+    {
+        ///Coordinates of vertices: x0, y0, x1, y1, ...
+        vector<double> vertices;
+        ///Vertices of quadrangles in deal.II(lexicographic) order, 4 per quadrangle.
+        vector<unsigned> quadrangles;
+        ///Material id of each quadrangle.
+        vector<int> quadrangle_material_ids;
+        ///Vertices of boundary lines, 2 per line.
+        vector<unsigned> lines;
+        ///Boundary id of each line, -1 for inner lines.
+        vector<int> line_material_ids;
+
+        inline size_t get_n_vertices() const { return vertices.size() / 2; }
+        inline size_t get_n_quadrangles() const { return quadrangle_material_ids.size(); }
+        inline size_t get_n_lines() const { return line_material_ids.size(); }
+
+        ///Removes all data.
+        void clear();
+
+        /**
+        * Hash of all arrays(FNV-1a over their bytes).
+        * Meshes with same fingerprint have the same vertices, elements and ids,
+        * so results which depend only on mesh can be reused.
+        */
+        uint64_t fingerprint() const;
+
+        /**
+        * Write the mesh into the file in Gmsh 2.2 ascii format, same as Mesh::write does.
+        * @param file - the name of the mesh file
+        */
+        void write(const string &file) const;
+
+        /**
+        * Write the mesh into the file in chosen format.
+        * Binary formats dump coordinates and element data as raw blocks,
+        * so large meshes are written without text formatting.
+        * Gmsh 4.1 format has no physical group for inner lines(negative material id), so they are skipped.
+        * @param file - the name of the mesh file
+        * @param format - format of the file, nothing is written for MSH_NONE
+        */
+        void write(const string &file, MshFormat format) const;
+
+    private:
+        ///Writes Gmsh 2.2 binary file.
+        void write_binary(const string &file) const;
+
+        ///Writes Gmsh 4.1 binary file.
+        void write_v41_binary(const string &file) const;
+    };
+
     //-------------------------------------------------------
     //
     // Auxiliary functions
@@ -0,0 +1,105 @@
+/*
+ * riversim - river growth simulation.
+ * Copyright (c) 2019 Oleg Kmechak
+ * Report issues: github.com/okmechak/RiverSim/issues
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ */
+
+#include "timers.hpp"
+
+///\cond
+#include <iomanip>
+#include <algorithm>
+///\endcond
+
+namespace River
+{
+    void Timers::add(const string &phase, const double seconds)
+    {
+        auto &p = phases[phase];
+        p.step_time += seconds;
+        p.total_time += seconds;
+        ++p.step_calls;
+        ++p.total_calls;
+    }
+
+    void Timers::count(const string &counter, const double value)
+    {
+        auto &c = counters[counter];
+        c.step_value += value;
+        c.total_value += value;
+    }
+
+    void Timers::next_step()
+    {
+        for (auto &[name, phase]: phases)
+        {
+            phase.step_time = 0;
+            phase.step_calls = 0;
+        }
+        for (auto &[name, counter]: counters)
+            counter.step_value = 0;
+    }
+
+    void Timers::clear()
+    {
+        phases.clear();
+        counters.clear();
+    }
+
+    Timers& Timers::operator+=(const Timers &timers)
+    {
+        for (const auto &[name, phase]: timers.phases)
+        {
+            auto &p = phases[name];
+            p.step_time += phase.step_time;
+            p.total_time += phase.total_time;
+            p.step_calls += phase.step_calls;
+            p.total_calls += phase.total_calls;
+        }
+        for (const auto &[name, counter]: timers.counters)
+        {
+            auto &c = counters[name];
+            c.step_value += counter.step_value;
+            c.total_value += counter.total_value;
+        }
+        return *this;
+    }
+
+    ostream& operator<<(ostream& write, const Timers &timers)
+    {
+        //subphases are already counted in their phases
+        double total_time = 0;
+        for (const auto &[name, phase]: timers.phases)
+            if (name.find('/') == string::npos)
+                total_time += phase.total_time;
+
+        const auto flags = write.flags();
+        const auto precision = write.precision();
+        write << left << setw(28) << "phase" << right << setw(10) << "calls" << setw(14) << "time, s" << setw(10) << "share" << endl;
+        for (const auto &[name, phase]: timers.phases)
+        {
+            //subphases follow their phases in map and are indented by level
+            const auto level = count(name.begin(), name.end(), '/');
+            const auto short_name = string(2 * level, ' ') + name.substr(name.rfind('/') + 1);
+            write << left << setw(28) << short_name << right << setw(10) << phase.total_calls
+                << setw(14) << fixed << setprecision(4) << phase.total_time
+                << setw(9) << setprecision(1) << (total_time > 0 ? 100 * phase.total_time / total_time : 0.) << "%" << endl;
+        }
+
+        for (const auto &[name, counter]: timers.counters)
+            write << left << setw(28) << name << right << setw(10) << defaultfloat << setprecision(precision) << counter.total_value << endl;
+
+        write.flags(flags);
+        write.precision(precision);
+        return write;
+    }
+}
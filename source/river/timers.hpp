@@ -0,0 +1,107 @@
+/*
+    riversim - river growth simulation.
+    Copyright (c) 2019 Oleg Kmechak
+    Report issues: github.com/okmechak/RiverSim/issues
+
+    This program is free software; you can redistribute it and/or
+    modify it under the terms of the GNU General Public License
+    as published by the Free Software Foundation; either version 2
+    of the License, or (at your option) any later version.
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+    GNU General Public License for more details.
+ */
+
+/*! \file timers.hpp
+    \brief Wall time and counters of simulation phases.
+    \details Each module(River::Triangle, River::Solver, River::RiverSolver) holds its own River::Timers object,
+    phases are timed by scopes, and River::RiverSolver collects values of each growth step into simulation data.
+ */
+#pragma once
+
+///\cond
+#include <map>
+#include <string>
+#include <chrono>
+#include <iostream>
+///\endcond
+
+using namespace std;
+
+namespace River
+{
+    /*! \brief Accumulates wall time and number of calls of named phases and values of named counters.
+        \details Values are kept twice: for current step, which are reset by next_step(), and totals.
+        Name of subphase is prefixed by name of phase it is part of, e.g. "Solve/Assembly" is part of "Solve".
+        Object isn't thread safe, so phases which run in parallel should be timed as whole.
+    */
+    class Timers
+    {
+        public:
+            ///Time and calls of one phase.
+            struct Phase
+            {
+                double step_time = 0, total_time = 0;
+                unsigned long step_calls = 0, total_calls = 0;
+            };
+
+            ///Value of one counter.
+            struct Counter
+            {
+                double step_value = 0, total_value = 0;
+            };
+
+            ///Adds wall time between its construction and destruction to phase.
+            class Scope
+            {
+                public:
+                    Scope(Timers &timers, const string &phase):
+                        timers{timers},
+                        phase{phase},
+                        start{chrono::steady_clock::now()}
+                    {}
+
+                    Scope(const Scope&) = delete;
+                    Scope& operator=(const Scope&) = delete;
+
+                    ~Scope()
+                    {
+                        timers.add(phase, chrono::duration<double>(chrono::steady_clock::now() - start).count());
+                    }
+
+                private:
+                    Timers &timers;
+                    string phase;
+                    chrono::steady_clock::time_point start;
+            };
+
+            ///Returns scope which times \p phase till the end of block.
+            Scope scope(const string &phase)
+            {
+                return Scope(*this, phase);
+            }
+
+            ///Adds \p seconds to \p phase and increments its number of calls.
+            void add(const string &phase, const double seconds);
+
+            ///Adds \p value to \p counter.
+            void count(const string &counter, const double value = 1);
+
+            ///Resets values of current step, totals are kept.
+            void next_step();
+
+            ///Removes all phases and counters.
+            void clear();
+
+            ///Adds phases and counters of \p timers.
+            Timers& operator+=(const Timers &timers);
+
+            map<string, Phase> phases;
+
+            map<string, Counter> counters;
+
+            ///Prints table of total time, calls and share(of time of all top level phases) of each phase and totals of counters.
+            friend ostream& operator<<(ostream& write, const Timers &timers);
+    };
+}
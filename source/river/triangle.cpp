@@ -16,8 +16,14 @@
 #include "triangle.hpp"
 ///\cond
 #include <iostream>
+#include <algorithm>
 #include <numeric>///< iota
 #include <iterator>///< ostream_iterator
+#include <map>
+#include <unordered_map>
+#include <unordered_set>
+#include <tuple>
+#include <cmath>
 ///\endcond
 
 namespace River{
@@ -226,8 +232,6 @@ namespace River{
         const struct triangulateio &io, tethex::Mesh &initMesh) const
     {
         vector<tethex::Point> pointsVal;
-        vector<tethex::MeshElement*> segmentsVal;
-        vector<tethex::MeshElement*> trianglesVal;
 
         pointsVal.reserve(io.numberofpoints);
         for(int i = 0; i < io.numberofpoints; ++i)
@@ -239,7 +243,10 @@ namespace River{
             pointsVal.push_back(tethex::Point(x, y, 0/*z-component*/, regionTag));
         }
 
-        segmentsVal.reserve(io.numberofsegments);
+        initMesh.set_vertexes(pointsVal);
+        initMesh.set_lines({});
+        initMesh.set_triangles({});
+
         for(int i = 0; i < io.numberofsegments; ++i)
         {
             auto v1 = io.segmentlist[2*i] - 1,//NOTE vertices index should start from zero
@@ -247,10 +254,9 @@ namespace River{
                 regionTag = io.segmentmarkerlist[i];
             if(regionTag == 0)//NOTE boundary_id of inner cells in Deal.II should be -1
                 regionTag = -1;
-            segmentsVal.push_back(new tethex::Line(v1, v2, regionTag));
+            initMesh.add_line(tethex::Line(v1, v2, regionTag));
         }
 
-        trianglesVal.reserve(io.numberoftriangles);
         for(int i = 0; i < io.numberoftriangles; ++i)
         {
             auto v1 = io.trianglelist[3*i] - 1,//NOTE vertice index should start from zero
@@ -262,12 +268,181 @@ namespace River{
             if(io.numberoftriangleattributes != 0)
                 regionTag = io.triangleattributelist[io.numberoftriangleattributes * i];
 
-            trianglesVal.push_back(new tethex::Triangle(v1, v2, v3, regionTag));
+            initMesh.add_triangle(tethex::Triangle(v1, v2, v3, regionTag));
         }
+    }
 
-        initMesh.set_vertexes(pointsVal);
-        initMesh.set_lines(segmentsVal);
-        initMesh.set_triangles(trianglesVal);
+    struct triangulateio Triangle::boundary_to_io(const Boundary &boundary, const t_PointList &holes) const
+    {
+        struct triangulateio io;
+        set_tria_to_default(&io);
+
+        //Points
+        if(!boundary.vertices.empty())
+        {
+            auto vertices_num = boundary.vertices.size();
+            io.pointlist = new REAL[2 * vertices_num];
+            io.pointmarkerlist = new int[vertices_num];
+            io.numberofpoints = vertices_num;
+
+            for(size_t i = 0; i < vertices_num; ++i)
+            {
+                io.pointlist[2 * i] = boundary.vertices[i].x;
+                io.pointlist[2 * i + 1] = boundary.vertices[i].y;
+                io.pointmarkerlist[i] = 0;
+            }
+        }
+
+        //Holes
+        if(!holes.empty())
+        {
+            io.numberofholes = holes.size();
+            io.holelist = new REAL[2 * holes.size()];
+            for(size_t i = 0; i < holes.size(); ++i)
+            {
+                io.holelist[2 * i] = holes[i].x;
+                io.holelist[2 * i + 1] = holes[i].y;
+            }
+        }
+
+        //Segments
+        if(!boundary.lines.empty())
+        {
+            auto lines_num = boundary.lines.size();
+            io.segmentlist = new int[2 * lines_num];
+            io.segmentmarkerlist = new int[lines_num];
+            io.numberofsegments = lines_num;
+            for(size_t i = 0; i < lines_num; ++i)
+            {
+                io.segmentlist[2 * i] = boundary.lines[i].p1 + 1;
+                io.segmentlist[2 * i + 1] = boundary.lines[i].p2 + 1;
+                io.segmentmarkerlist[i] = boundary.lines[i].boundary_id;
+            }
+        }
+
+        return io;
+    }
+
+    void Triangle::io_to_flat(const struct triangulateio &io, tethex::FlatMesh &mesh) const
+    {
+        //NOTE vertices index of Triangle starts from one
+        const int n_points = io.numberofpoints,
+            n_triangles = io.numberoftriangles;
+        auto vertex = [&io](int tri, int k){ return io.trianglelist[3 * tri + k] - 1; };
+
+        //Edges numeration: each edge {lo, hi} is stored in row lo of compressed row arrays
+        vector<int> row_start(n_points + 1, 0);
+        for(int tri = 0; tri < n_triangles; ++tri)
+            for(int k = 0; k < 3; ++k)
+                ++row_start[min(vertex(tri, k), vertex(tri, (k + 1) % 3)) + 1];
+        for(int i = 0; i < n_points; ++i)
+            row_start[i + 1] += row_start[i];
+
+        vector<int> row_cols(row_start.back()), 
+            position(row_start.begin(), row_start.end() - 1);
+        for(int tri = 0; tri < n_triangles; ++tri)
+            for(int k = 0; k < 3; ++k)
+            {
+                auto a = vertex(tri, k), b = vertex(tri, (k + 1) % 3);
+                row_cols[position[min(a, b)]++] = max(a, b);
+            }
+
+        //inner edges are listed twice, so rows are sorted and compacted in place
+        vector<int> edge_start(n_points + 1, 0);
+        int n_edges = 0;
+        for(int i = 0; i < n_points; ++i)
+        {
+            auto begin = row_cols.begin() + row_start[i],
+                end = row_cols.begin() + row_start[i + 1];
+            sort(begin, end);
+            end = unique(begin, end);
+            edge_start[i] = n_edges;
+            n_edges = copy(begin, end, row_cols.begin() + n_edges) - row_cols.begin();
+        }
+        edge_start[n_points] = n_edges;
+
+        auto find_edge = [&](int a, int b)
+        {
+            auto lo = min(a, b), hi = max(a, b);
+            auto begin = row_cols.begin() + edge_start[lo],
+                end = row_cols.begin() + edge_start[lo + 1];
+            auto it = lower_bound(begin, end, hi);
+            if(it == end || *it != hi)
+                throw Exception("io_to_flat: there is no edge {" + to_string(a) + ", " + to_string(b) + "} in mesh");
+            return int(it - row_cols.begin());
+        };
+
+        //Vertices: original ones, then middle of edges, then centers of triangles
+        auto &v = mesh.vertices;
+        v.resize(2 * (n_points + n_edges + n_triangles));
+        for(int i = 0; i < 2 * n_points; ++i)
+            v[i] = io.pointlist[i];
+        for(int i = 0; i < n_points; ++i)
+            for(int e = edge_start[i]; e < edge_start[i + 1]; ++e)
+                for(int c = 0; c < 2; ++c)
+                    v[2 * (n_points + e) + c] = (v[2 * i + c] + v[2 * row_cols[e] + c]) / 2.;
+        for(int tri = 0; tri < n_triangles; ++tri)
+            for(int c = 0; c < 2; ++c)
+                v[2 * (n_points + n_edges + tri) + c] = 
+                    (v[2 * vertex(tri, 0) + c] + v[2 * vertex(tri, 1) + c] + v[2 * vertex(tri, 2) + c]) / 3.;
+
+        //Quadrangles: one for each vertex of triangle
+        mesh.quadrangles.resize(4 * 3 * n_triangles);
+        mesh.quadrangle_material_ids.resize(3 * n_triangles);
+        for(int tri = 0; tri < n_triangles; ++tri)
+        {
+            //taking only the first one attribute
+            int material_id = 0;
+            if(io.numberoftriangleattributes != 0)
+                material_id = io.triangleattributelist[io.numberoftriangleattributes * tri];
+
+            int edges[3];
+            for(int k = 0; k < 3; ++k)
+                edges[k] = n_points + find_edge(vertex(tri, k), vertex(tri, (k + 1) % 3));
+
+            for(int k = 0; k < 3; ++k)
+            {
+                //counterclockwise or clockwise order: vertex, edge middle, center, other edge middle
+                unsigned q[4] = {
+                    (unsigned)vertex(tri, k), 
+                    (unsigned)edges[k], 
+                    (unsigned)(n_points + n_edges + tri), 
+                    (unsigned)edges[(k + 2) % 3]};
+
+                double area = 0;
+                for(int j = 0; j < 4; ++j)
+                    area += v[2 * q[j]] * v[2 * q[(j + 1) % 4] + 1] - v[2 * q[(j + 1) % 4]] * v[2 * q[j] + 1];
+                if(area < 0)
+                    swap(q[1], q[3]);
+
+                auto cell = 3 * tri + k;
+                mesh.quadrangles[4 * cell] = q[0];
+                mesh.quadrangles[4 * cell + 1] = q[1];
+                mesh.quadrangles[4 * cell + 2] = q[3];
+                mesh.quadrangles[4 * cell + 3] = q[2];
+                mesh.quadrangle_material_ids[cell] = material_id;
+            }
+        }
+
+        //Lines: each segment is split by its middle point
+        mesh.lines.resize(2 * 2 * io.numberofsegments);
+        mesh.line_material_ids.resize(2 * io.numberofsegments);
+        for(int i = 0; i < io.numberofsegments; ++i)
+        {
+            auto v1 = io.segmentlist[2 * i] - 1,
+                v2 = io.segmentlist[2 * i + 1] - 1,
+                regionTag = io.segmentmarkerlist[i];
+            if(regionTag == 0)//NOTE boundary_id of inner cells in Deal.II should be -1
+                regionTag = -1;
+            auto middle = n_points + find_edge(v1, v2);
+
+            mesh.lines[4 * i] = v1;
+            mesh.lines[4 * i + 1] = middle;
+            mesh.lines[4 * i + 2] = middle;
+            mesh.lines[4 * i + 3] = v2;
+            mesh.line_material_ids[2 * i] = regionTag;
+            mesh.line_material_ids[2 * i + 1] = regionTag;
+        }
     }
 
     /*
@@ -317,6 +492,10 @@ namespace River{
 
     void Triangle::free_allocated_memory()
     {
+        //holes are allocated here and aren't released by triangulateiofree, out.holelist is the same array
+        delete[] in.holelist;
+        in.holelist = NULL;
+        out.holelist = NULL;
 
         triangulateiofree(&in);
         triangulateiofree(&out);
@@ -440,7 +619,637 @@ namespace River{
 
         tethex::Mesh mesh_object(boundary, holes);
         in = tethex_to_io(mesh_object);
+        triangulate_input();
+
+        {
+            auto timer = timers.scope("MeshGeneration/Conversion");
+            io_to_tethex(out, mesh_object);
+            mesh_object.convert();
+        }
+        free_allocated_memory();
+
+        return mesh_object;
+    }
+
+    tethex::FlatMesh Triangle::generate_flat_quadrangular_mesh(const Boundary &boundary, const t_PointList &holes)
+    {
+        set_all_values_to_default();
+
+        in = boundary_to_io(boundary, holes);
+        triangulate_input();
+
+        tethex::FlatMesh mesh;
+        try
+        {
+            auto timer = timers.scope("MeshGeneration/Conversion");
+            io_to_flat(out, mesh);
+        }
+        catch (...)
+        {
+            free_allocated_memory();
+            throw;
+        }
+        free_allocated_memory();
+
+        return mesh;
+    }
+
+    /*
+        Incremental remeshing
+    */
+
+    ///Signed doubled area of triangle {\p o, \p a, \p b}.
+    static double cross(const Point &o, const Point &a, const Point &b)
+    {
+        return (a.x - o.x) * (b.y - o.y) - (a.y - o.y) * (b.x - o.x);
+    }
+
+    ///Distance from point \p p to segment {\p a, \p b}.
+    static double point_segment_distance(const Point &p, const Point &a, const Point &b)
+    {
+        auto ab = b - a;
+        auto length2 = ab * ab;
+        auto t = length2 > 0 ? ((p - a) * ab) / length2 : 0.;
+        t = max(0., min(1., t));
+        return (p - (a + ab * t)).norm();
+    }
+
+    ///Distance between segments {\p a, \p b} and {\p c, \p d}.
+    static double segments_distance(const Point &a, const Point &b, const Point &c, const Point &d)
+    {
+        auto d1 = cross(c, d, a), d2 = cross(c, d, b),
+            d3 = cross(a, b, c), d4 = cross(a, b, d);
+        if(((d1 > 0 && d2 < 0) || (d1 < 0 && d2 > 0)) && ((d3 > 0 && d4 < 0) || (d3 < 0 && d4 > 0)))
+            return 0;
+        return min({
+            point_segment_distance(a, c, d), point_segment_distance(b, c, d),
+            point_segment_distance(c, a, b), point_segment_distance(d, a, b)});
+    }
+
+    ///Distance between triangle {\p p1, \p p2, \p p3} and segment {\p a, \p b}.
+    static double triangle_segment_distance(const Point &p1, const Point &p2, const Point &p3, const Point &a, const Point &b)
+    {
+        auto s1 = cross(p1, p2, a), s2 = cross(p2, p3, a), s3 = cross(p3, p1, a);
+        if((s1 >= 0 && s2 >= 0 && s3 >= 0) || (s1 <= 0 && s2 <= 0 && s3 <= 0))
+            return 0;
+        return min({segments_distance(p1, p2, a, b), segments_distance(p2, p3, a, b), segments_distance(p3, p1, a, b)});
+    }
+
+    ///Convex hull of \p points in counterclockwise order(Andrew's monotone chain).
+    static t_PointList convex_hull(t_PointList points)
+    {
+        sort(points.begin(), points.end(), [](const Point &a, const Point &b){ return a.x < b.x || (a.x == b.x && a.y < b.y); });
+        if(points.size() < 3)
+            return points;
+
+        t_PointList hull(2 * points.size());
+        size_t k = 0;
+        for(size_t i = 0; i < points.size(); ++i)
+        {
+            while(k >= 2 && cross(hull[k - 2], hull[k - 1], points[i]) <= 0)
+                --k;
+            hull[k++] = points[i];
+        }
+        for(size_t i = points.size() - 1, lower = k + 1; i > 0; --i)
+        {
+            while(k >= lower && cross(hull[k - 2], hull[k - 1], points[i - 1]) <= 0)
+                --k;
+            hull[k++] = points[i - 1];
+        }
+        hull.resize(k - 1);
+        return hull;
+    }
+
+    ///Key of edge {\p a, \p b} independent of vertices order.
+    static uint64_t edge_key(int a, int b)
+    {
+        if(a > b)
+            swap(a, b);
+        return (uint64_t(uint32_t(a)) << 32) | uint32_t(b);
+    }
+
+    void Triangle::triangulate_and_store(const Boundary &boundary, const t_PointList &holes)
+    {
+        set_all_values_to_default();
+
+        in = boundary_to_io(boundary, holes);
+        //segments are marked by indices of lines, so subsegments can be matched with lines at next update
+        for(int i = 0; i < in.numberofsegments; ++i)
+            in.segmentmarkerlist[i] = i + 1;
+        triangulate_input();
+
+        stored.points.assign(out.pointlist, out.pointlist + 2 * out.numberofpoints);
+        stored.triangles.assign(out.trianglelist, out.trianglelist + 3 * out.numberoftriangles);
+        stored.segments.assign(out.segmentlist, out.segmentlist + 2 * out.numberofsegments);
+        stored.segment_lines.assign(out.segmentmarkerlist, out.segmentmarkerlist + out.numberofsegments);
+        //taking only the first one attribute
+        stored.triangle_attributes.assign(out.numberoftriangles, 0.);
+        if(out.numberoftriangleattributes != 0)
+            for(int i = 0; i < out.numberoftriangles; ++i)
+                stored.triangle_attributes[i] = out.triangleattributelist[out.numberoftriangleattributes * i];
+        free_allocated_memory();
+
+        stored.boundary = boundary;
+        stored.holes = holes;
+        stored.tip_points = mesh_params.tip_points;
+        stored.mesh_params = mesh_params;
+        stored.n_updates = 0;
+    }
+
+    bool Triangle::remesh_cavities(const Boundary &boundary, const t_PointList &holes)
+    {
+        const auto radius = mesh_params.remeshing_radius;
+        if(stored.triangles.empty() || radius <= 0
+            || (mesh_params.full_remeshing_period && stored.n_updates >= mesh_params.full_remeshing_period)
+            || !(mesh_params == stored.mesh_params) || holes != stored.holes)
+            return false;
+
+        //Boundary lines are matched by coordinates of vertices, not matched ones are changed
+        typedef tuple<double, double, double, double, t_boundary_id> t_line_key;
+        auto line_key = [](const Boundary &b, const Line &l)
+        {
+            const auto &p1 = b.vertices.at(l.p1), &p2 = b.vertices.at(l.p2);
+            return t_line_key{p1.x, p1.y, p2.x, p2.y, l.boundary_id};
+        };
+        multimap<t_line_key, size_t> removed_lines;
+        for(size_t i = 0; i < stored.boundary.lines.size(); ++i)
+            removed_lines.emplace(line_key(stored.boundary, stored.boundary.lines[i]), i);
+
+        vector<long> old_to_new_line(stored.boundary.lines.size(), -1);
+        vector<size_t> added_lines;
+        for(size_t i = 0; i < boundary.lines.size(); ++i)
+        {
+            auto it = removed_lines.find(line_key(boundary, boundary.lines[i]));
+            if(it == removed_lines.end())
+                added_lines.push_back(i);
+            else
+            {
+                old_to_new_line[it->second] = i;
+                removed_lines.erase(it);
+            }
+        }
+
+        //Cavities: triangles closer then radius to old and new tips or to changed lines(capsules)
+        vector<pair<Point, Point>> capsules;
+        for(const auto &tip: stored.tip_points)
+            capsules.push_back({tip, tip});
+        for(const auto &tip: mesh_params.tip_points)
+            capsules.push_back({tip, tip});
+        for(const auto &[key, i]: removed_lines)
+        {
+            const auto &line = stored.boundary.lines[i];
+            capsules.push_back({stored.boundary.vertices[line.p1], stored.boundary.vertices[line.p2]});
+        }
+        for(auto i: added_lines)
+        {
+            const auto &line = boundary.lines[i];
+            capsules.push_back({boundary.vertices[line.p1], boundary.vertices[line.p2]});
+        }
+
+        const int n_triangles = stored.triangles.size() / 3;
+        auto point = [this](int v){ return Point{(double)stored.points[2 * (v - 1)], (double)stored.points[2 * (v - 1) + 1]}; };
+        auto vertex = [this](int tri, int k){ return stored.triangles[3 * tri + k]; };
+
+        vector<bool> is_removed(n_triangles, false);
+        int n_removed = 0;
+        if(!capsules.empty())
+        {
+            //capsules are indexed by uniform grid, so each triangle is tested only with nearby capsules
+            double x_min = numeric_limits<double>::max(), y_min = x_min,
+                x_max = numeric_limits<double>::lowest(), y_max = x_max;
+            for(const auto &[a, b]: capsules)
+            {
+                x_min = min({x_min, a.x - radius, b.x - radius});
+                y_min = min({y_min, a.y - radius, b.y - radius});
+                x_max = max({x_max, a.x + radius, b.x + radius});
+                y_max = max({y_max, a.y + radius, b.y + radius});
+            }
+            const double max_cells = 1 << 20,
+                cell = max(2 * radius, sqrt((x_max - x_min) * (y_max - y_min) / max_cells));
+            const long nx = (x_max - x_min) / cell + 1, ny = (y_max - y_min) / cell + 1;
+            auto cell_x = [&](double x){ return min(nx - 1, max(0l, long((x - x_min) / cell))); };
+            auto cell_y = [&](double y){ return min(ny - 1, max(0l, long((y - y_min) / cell))); };
+
+            vector<size_t> cell_start(nx * ny + 1, 0), cell_capsules;
+            for(int pass = 0; pass < 2; ++pass)
+            {
+                vector<size_t> position(cell_start.begin(), cell_start.end() - 1);
+                for(size_t c = 0; c < capsules.size(); ++c)
+                {
+                    const auto &[a, b] = capsules[c];
+                    for(auto j = cell_y(min(a.y, b.y) - radius); j <= cell_y(max(a.y, b.y) + radius); ++j)
+                        for(auto i = cell_x(min(a.x, b.x) - radius); i <= cell_x(max(a.x, b.x) + radius); ++i)
+                            if(pass == 0)
+                                ++cell_start[j * nx + i + 1];
+                            else
+                                cell_capsules[position[j * nx + i]++] = c;
+                }
+                if(pass == 0)
+                {
+                    partial_sum(cell_start.begin(), cell_start.end(), cell_start.begin());
+                    cell_capsules.resize(cell_start.back());
+                }
+            }
+
+            for(int tri = 0; tri < n_triangles; ++tri)
+            {
+                auto p1 = point(vertex(tri, 0)), p2 = point(vertex(tri, 1)), p3 = point(vertex(tri, 2));
+                auto t_x_min = min({p1.x, p2.x, p3.x}), t_x_max = max({p1.x, p2.x, p3.x}),
+                    t_y_min = min({p1.y, p2.y, p3.y}), t_y_max = max({p1.y, p2.y, p3.y});
+                if(t_x_max < x_min || t_x_min > x_max || t_y_max < y_min || t_y_min > y_max)
+                    continue;
+
+                for(auto j = cell_y(t_y_min); j <= cell_y(t_y_max) && !is_removed[tri]; ++j)
+                    for(auto i = cell_x(t_x_min); i <= cell_x(t_x_max) && !is_removed[tri]; ++i)
+                        for(auto k = cell_start[j * nx + i]; k < cell_start[j * nx + i + 1]; ++k)
+                        {
+                            const auto &[a, b] = capsules[cell_capsules[k]];
+                            if(triangle_segment_distance(p1, p2, p3, a, b) < radius)
+                            {
+                                is_removed[tri] = true;
+                                ++n_removed;
+                                break;
+                            }
+                        }
+            }
+        }
+
+        //there is no sense to remesh locally most of the region
+        if(2 * n_removed > n_triangles)
+            return false;
+
+        //Edges of removed triangles, ones that are listed once bound cavities
+        struct t_cavity_edge {int count = 0, opposite = 0;};
+        unordered_map<uint64_t, t_cavity_edge> cavity_edges;
+        cavity_edges.reserve(3 * n_removed);
+        double removed_area = 0;
+        for(int tri = 0; tri < n_triangles; ++tri)
+            if(is_removed[tri])
+            {
+                for(int k = 0; k < 3; ++k)
+                {
+                    auto &edge = cavity_edges[edge_key(vertex(tri, k), vertex(tri, (k + 1) % 3))];
+                    ++edge.count;
+                    edge.opposite = vertex(tri, (k + 2) % 3);
+                }
+                removed_area += abs(cross(point(vertex(tri, 0)), point(vertex(tri, 1)), point(vertex(tri, 2)))) / 2;
+            }
+
+        //Segments which lines aren't changed are kept, ones inside of cavities also bound them
+        unordered_map<uint64_t, int> segments_by_edges;
+        vector<int> segments, segment_lines;
+        const int n_segments = stored.segment_lines.size();
+        for(int s = 0; s < n_segments; ++s)
+        {
+            auto new_line = old_to_new_line.at(stored.segment_lines[s] - 1);
+            segments_by_edges[edge_key(stored.segments[2 * s], stored.segments[2 * s + 1])] = new_line;
+            if(new_line < 0)
+                continue;
+            segments.push_back(stored.segments[2 * s]);
+            segments.push_back(stored.segments[2 * s + 1]);
+            segment_lines.push_back(new_line + 1);
+        }
+
+        //PSLG of cavities: its points are either old ones(global index) or new ones(zero index)
+        t_PointList pslg_points;
+        vector<int> pslg_global, pslg_segments;
+        t_PointList hole_points = holes;
+        unordered_map<int, int> global_to_pslg;
+        map<pair<double, double>, int> pslg_by_coords;
+        auto pslg_point = [&](int global, const Point &p)
+        {
+            if(global)
+            {
+                auto it = global_to_pslg.find(global);
+                if(it != global_to_pslg.end())
+                    return it->second;
+            }
+            auto it = pslg_by_coords.find({p.x, p.y});
+            if(it != pslg_by_coords.end())
+                return it->second;
+
+            int local = pslg_points.size();
+            pslg_points.push_back(p);
+            pslg_global.push_back(global);
+            pslg_by_coords[{p.x, p.y}] = local;
+            if(global)
+                global_to_pslg[global] = local;
+            return local;
+        };
+
+        for(const auto &[key, edge]: cavity_edges)
+        {
+            int a = key >> 32, b = key & 0xffffffff;
+            auto segment = segments_by_edges.find(key);
+            if(segment != segments_by_edges.end())
+            {
+                //lines which are changed are replaced by new ones
+                if(segment->second < 0)
+                    continue;
+            }
+            else if(edge.count == 1)
+            {
+                //edge between removed and kept triangles, hole point is placed a bit inside of kept one
+                auto pa = point(a), pb = point(b), middle = (pa + pb) / 2.;
+                auto normal = Point{pa.y - pb.y, pb.x - pa.x} * 1e-3;
+                if(normal * (point(edge.opposite) - middle) > 0)
+                    normal = normal * -1.;
+                hole_points.push_back(middle + normal);
+            }
+            else
+                continue;
+
+            pslg_segments.push_back(pslg_point(a, point(a)));
+            pslg_segments.push_back(pslg_point(b, point(b)));
+        }
+
+        //New lines are split in advance by area constraint, cos Steiner points on cavities boundary are prohibited.
+        //Parts of line are bisected until they are not longer then edge of equilateral triangle with constrained area.
+        auto edge_length = [this](const Point &p)
+        {
+            auto area = mesh_params.meshAreaConstraint(p.x, p.y);
+            return max(mesh_params.min_edge, min(mesh_params.max_edge, sqrt(4. / sqrt(3.) * area)));
+        };
+        vector<int> new_segments;
+        for(auto i: added_lines)
+        {
+            const auto &line = boundary.lines[i];
+            auto a = boundary.vertices[line.p1], b = boundary.vertices[line.p2];
+
+            vector<double> parameters;
+            vector<pair<double, double>> parts{{0., 1.}};
+            while(!parts.empty())
+            {
+                auto [t0, t1] = parts.back();
+                parts.pop_back();
+                auto p0 = a + (b - a) * t0, p1 = a + (b - a) * t1;
+                if(t1 - t0 > 1e-6 && (p1 - p0).norm() > min({edge_length(p0), edge_length(p1), edge_length((p0 + p1) / 2.)}))
+                {
+                    parts.push_back({(t0 + t1) / 2, t1});
+                    parts.push_back({t0, (t0 + t1) / 2});
+                }
+                else
+                    parameters.push_back(t1);
+            }
+
+            auto previous = pslg_point(0, a);
+            for(auto t: parameters)
+            {
+                auto current = pslg_point(0, t == 1. ? b : a + (b - a) * t);
+                if(current == previous)
+                    continue;
+                pslg_segments.push_back(previous);
+                pslg_segments.push_back(current);
+                new_segments.push_back(previous);
+                new_segments.push_back(current);
+                new_segments.push_back(i + 1);
+                previous = current;
+            }
+        }
+
+        //Triangle fails to locate some holes, which are outside of convex hull of PSLG, so they are skipped
+        auto hull = convex_hull(pslg_points);
+        auto is_inside_hull = [&hull](const Point &p)
+        {
+            for(size_t i = 0; i < hull.size(); ++i)
+                if(cross(hull[i], hull[(i + 1) % hull.size()], p) <= 0)
+                    return false;
+            return hull.size() > 2;
+        };
+        hole_points.erase(remove_if(hole_points.begin(), hole_points.end(), 
+            [&is_inside_hull](const Point &p){ return !is_inside_hull(p); }), hole_points.end());
+
+        //Triangulation of cavities
+        const int n_pslg_points = pslg_points.size();
+        const int n_pslg_segments = pslg_segments.size() / 2;
+        if(n_pslg_segments)
+        {
+            set_all_values_to_default();
+            SteinerPointsOnBoundary = true;
+            update_options();
+            SteinerPointsOnBoundary = false;
+
+            in.numberofpoints = n_pslg_points;
+            in.pointlist = new REAL[2 * n_pslg_points];
+            in.pointmarkerlist = new int[n_pslg_points];
+            for(int i = 0; i < n_pslg_points; ++i)
+            {
+                in.pointlist[2 * i] = pslg_points[i].x;
+                in.pointlist[2 * i + 1] = pslg_points[i].y;
+                in.pointmarkerlist[i] = 0;
+            }
+            in.numberofsegments = n_pslg_segments;
+            in.segmentlist = new int[2 * n_pslg_segments];
+            in.segmentmarkerlist = new int[n_pslg_segments];
+            for(int i = 0; i < n_pslg_segments; ++i)
+            {
+                in.segmentlist[2 * i] = pslg_segments[2 * i] + 1;
+                in.segmentlist[2 * i + 1] = pslg_segments[2 * i + 1] + 1;
+                in.segmentmarkerlist[i] = 1;
+            }
+            in.numberofholes = hole_points.size();
+            in.holelist = new REAL[2 * hole_points.size()];
+            for(size_t i = 0; i < hole_points.size(); ++i)
+            {
+                in.holelist[2 * i] = hole_points[i].x;
+                in.holelist[2 * i + 1] = hole_points[i].y;
+            }
+
+            try
+            {
+                triangulate_input();
+            }
+            catch(const Exception &)
+            {
+                return false;
+            }
+        }
+        else if(n_removed)
+            return false;
+
+        //Checks: each segment of PSLG is edge of new triangles, area of cavities is preserved 
+        //and new triangles are not much worse then ones of full triangulation
+        const int n_new_triangles = n_pslg_segments ? out.numberoftriangles : 0;
+        auto new_vertex = [this](int tri, int k){ return out.trianglelist[3 * tri + k]; };
+        auto new_point = [this](int v){ return Point{(double)out.pointlist[2 * (v - 1)], (double)out.pointlist[2 * (v - 1) + 1]}; };
+        unordered_set<uint64_t> new_edges;
+        double new_area = 0, min_sin = 1;
+        for(int tri = 0; tri < n_new_triangles; ++tri)
+        {
+            Point p[3];
+            for(int k = 0; k < 3; ++k)
+            {
+                new_edges.insert(edge_key(new_vertex(tri, k), new_vertex(tri, (k + 1) % 3)));
+                p[k] = new_point(new_vertex(tri, k));
+            }
+            auto doubled_area = abs(cross(p[0], p[1], p[2]));
+            new_area += doubled_area / 2;
+            for(int k = 0; k < 3; ++k)
+                min_sin = min(min_sin, doubled_area / ((p[(k + 1) % 3] - p[k]).norm() * (p[(k + 2) % 3] - p[k]).norm()));
+        }
+        const bool is_good_quality = min_sin >= sin(mesh_params.min_angle / 2 * M_PI / 180);
+
+        bool is_conforming = true;
+        for(int i = 0; i < n_pslg_segments && is_conforming; ++i)
+            is_conforming = new_edges.count(edge_key(pslg_segments[2 * i] + 1, pslg_segments[2 * i + 1] + 1));
+
+        //difference of region areas is evaluated only by changed lines
+        double total_cross = 0, changed_cross = 0, abs_changed_cross = 0;
+        for(const auto &line: stored.boundary.lines)
+            total_cross += cross({0, 0}, stored.boundary.vertices[line.p1], stored.boundary.vertices[line.p2]);
+        for(const auto &[key, i]: removed_lines)
+        {
+            const auto &line = stored.boundary.lines[i];
+            auto c = cross({0, 0}, stored.boundary.vertices[line.p1], stored.boundary.vertices[line.p2]);
+            changed_cross -= c;
+            abs_changed_cross += abs(c);
+        }
+        for(auto i: added_lines)
+        {
+            const auto &line = boundary.lines[i];
+            auto c = cross({0, 0}, boundary.vertices[line.p1], boundary.vertices[line.p2]);
+            changed_cross += c;
+            abs_changed_cross += abs(c);
+        }
+        auto expected_area = removed_area + (total_cross < 0 ? -changed_cross : changed_cross) / 2;
+        auto tolerance = 1e-9 * (removed_area + new_area + abs_changed_cross);
+
+        if(!is_conforming || !is_good_quality || abs(new_area - expected_area) > tolerance)
+        {
+            if(n_pslg_segments)
+                free_allocated_memory();
+            return false;
+        }
+
+        //New triangulation: kept triangles and triangles of cavities
+        auto &points = stored.points;
+        vector<int> new_to_global(n_pslg_segments ? out.numberofpoints + 1 : 1, 0);
+        for(int v = 1; v < (int)new_to_global.size(); ++v)
+        {
+            if(v <= n_pslg_points && pslg_global[v - 1])
+                new_to_global[v] = pslg_global[v - 1];
+            else
+            {
+                points.push_back(out.pointlist[2 * (v - 1)]);
+                points.push_back(out.pointlist[2 * (v - 1) + 1]);
+                new_to_global[v] = points.size() / 2;
+            }
+        }
+
+        vector<int> triangles;
+        vector<REAL> triangle_attributes;
+        triangles.reserve(3 * (n_triangles - n_removed + n_new_triangles));
+        triangle_attributes.reserve(n_triangles - n_removed + n_new_triangles);
+        for(int tri = 0; tri < n_triangles; ++tri)
+            if(!is_removed[tri])
+            {
+                for(int k = 0; k < 3; ++k)
+                    triangles.push_back(vertex(tri, k));
+                triangle_attributes.push_back(stored.triangle_attributes[tri]);
+            }
+        for(int tri = 0; tri < n_new_triangles; ++tri)
+        {
+            for(int k = 0; k < 3; ++k)
+                triangles.push_back(new_to_global[new_vertex(tri, k)]);
+            //taking only the first one attribute
+            triangle_attributes.push_back(out.numberoftriangleattributes != 0 ? 
+                out.triangleattributelist[out.numberoftriangleattributes * tri] : 0.);
+        }
+        for(size_t i = 0; i < new_segments.size(); i += 3)
+        {
+            segments.push_back(new_to_global[new_segments[i] + 1]);
+            segments.push_back(new_to_global[new_segments[i + 1] + 1]);
+            segment_lines.push_back(new_segments[i + 2]);
+        }
+        if(n_pslg_segments)
+            free_allocated_memory();
+
+        //points which aren't used by triangles anymore are removed
+        vector<int> renumbering(points.size() / 2 + 1, 0);
+        for(auto v: triangles)
+            renumbering[v] = 1;
+        int n_used = 0;
+        for(size_t v = 1; v < renumbering.size(); ++v)
+            if(renumbering[v])
+            {
+                renumbering[v] = ++n_used;
+                points[2 * (n_used - 1)] = points[2 * (v - 1)];
+                points[2 * (n_used - 1) + 1] = points[2 * (v - 1) + 1];
+            }
+        points.resize(2 * n_used);
+        for(auto &v: triangles)
+            v = renumbering[v];
+        for(auto &v: segments)
+            v = renumbering[v];
+
+        stored.triangles = move(triangles);
+        stored.triangle_attributes = move(triangle_attributes);
+        stored.segments = move(segments);
+        stored.segment_lines = move(segment_lines);
+        stored.boundary = boundary;
+        stored.tip_points = mesh_params.tip_points;
+        ++stored.n_updates;
+
+        return true;
+    }
+
+    tethex::FlatMesh Triangle::stored_to_flat() const
+    {
+        //segments markers are set back to boundary ids
+        vector<int> segment_markers(stored.segment_lines.size());
+        for(size_t i = 0; i < segment_markers.size(); ++i)
+            segment_markers[i] = stored.boundary.lines.at(stored.segment_lines[i] - 1).boundary_id;
+
+        struct triangulateio io;
+        set_tria_to_default(&io);
+        io.numberofpoints = stored.points.size() / 2;
+        io.pointlist = const_cast<REAL*>(stored.points.data());
+        io.numberoftriangles = stored.triangles.size() / 3;
+        io.trianglelist = const_cast<int*>(stored.triangles.data());
+        io.numberoftriangleattributes = 1;
+        io.triangleattributelist = const_cast<REAL*>(stored.triangle_attributes.data());
+        io.numberofsegments = segment_markers.size();
+        io.segmentlist = const_cast<int*>(stored.segments.data());
+        io.segmentmarkerlist = segment_markers.data();
 
+        tethex::FlatMesh mesh;
+        io_to_flat(io, mesh);
+        return mesh;
+    }
+
+    tethex::FlatMesh Triangle::update_flat_quadrangular_mesh(const Boundary &boundary, const t_PointList &holes)
+    {
+        is_last_update_incremental = false;
+        if(mesh_params.remeshing_radius <= 0)
+        {
+            clear_triangulation();
+            return generate_flat_quadrangular_mesh(boundary, holes);
+        }
+
+        //tips index is used by area constraint while new lines are split
+        mesh_params.BuildTipsIndex();
+        is_last_update_incremental = remesh_cavities(boundary, holes);
+        if(!is_last_update_incremental)
+            triangulate_and_store(boundary, holes);
+        timers.count(is_last_update_incremental ? "IncrementalRemeshes" : "FullRemeshes");
+
+        auto timer = timers.scope("MeshGeneration/Conversion");
+        return stored_to_flat();
+    }
+
+    void Triangle::clear_triangulation()
+    {
+        stored = StoredTriangulation();
+    }
+
+    bool Triangle::last_update_is_incremental() const
+    {
+        return is_last_update_incremental;
+    }
+
+    void Triangle::triangulate_input()
+    {
+        auto timer = timers.scope("MeshGeneration/Triangulation");
         if (Verbose)
         {
             cout << "Input Geometry: " << endl;
@@ -448,7 +1257,16 @@ namespace River{
         }
 
         //Main call to Triangle
-        triangulate(options.c_str(), &in, &out, &vorout, &mesh_params);
+        try
+        {
+            triangulate(options.c_str(), &in, &out, &vorout, &mesh_params);
+        }
+        catch (...)
+        {
+            //Triangle reports errors by exceptions, so memory is released here
+            free_allocated_memory();
+            throw;
+        }
 
         if (Verbose)
         {
@@ -461,11 +1279,5 @@ namespace River{
             cout << "Voronoi Diagram: " << endl;
             print_geometry(vorout);
         }
-
-        io_to_tethex(out, mesh_object);
-        mesh_object.convert();
-        free_allocated_memory();
-
-        return mesh_object;
     }
 } //end of River namespace
\ No newline at end of file
@@ -24,6 +24,9 @@
 ///mesh convertor tool
 #include "tethex.hpp"
 
+///time of mesh generation phases
+#include "timers.hpp"
+
 using namespace std;
 
 
@@ -111,6 +114,53 @@ namespace River
             ///Converts \ref triangulateio to tethex::Mesh used by rest of program.
             void io_to_tethex(const struct triangulateio &io, tethex::Mesh &initMesh) const;
 
+            ///Converts Boundary and holes to \ref triangulateio used by Triangle.
+            struct triangulateio boundary_to_io(const Boundary &boundary, const t_PointList &holes) const;
+
+            /*! \brief Converts \ref triangulateio to quadrangular tethex::FlatMesh.
+                \details Each triangle is split into three quadrangles by its centroid and edge midpoints,
+                same as tethex::Mesh::convert does, but edges are numerated with flat compressed 
+                row arrays instead of IncidenceMatrix and no mesh elements are allocated.
+            */
+            void io_to_flat(const struct triangulateio &io, tethex::FlatMesh &mesh) const;
+
+            ///Calls Triangle for \ref in geometry and sets \ref out.
+            void triangulate_input();
+
+            /*! \brief Triangulation of previous \ref update_flat_quadrangular_mesh call.
+                \details Vertices indices start from one as in \ref triangulateio. Instead of boundary ids 
+                segments hold indices(starting from one) of \ref boundary lines, which they are part of.
+            */
+            struct StoredTriangulation
+            {
+                vector<REAL> points, triangle_attributes;
+                vector<int> triangles, segments, segment_lines;
+                ///Boundary, holes and tips for which triangulation was generated.
+                Boundary boundary;
+                t_PointList holes, tip_points;
+                MeshParams mesh_params;
+                ///Number of incremental updates since triangulation of whole region.
+                unsigned n_updates = 0;
+            } stored;
+
+            bool is_last_update_incremental = false;
+
+            ///Triangulates whole region and keeps result in \ref stored.
+            void triangulate_and_store(const Boundary &boundary, const t_PointList &holes);
+
+            /*! \brief Triangulates again only cavities of \ref stored triangulation around tips and changed boundary lines.
+                \details Cavity consists of triangles closer then MeshParams::remeshing_radius to old or new tip points
+                or to lines of boundary which are changed. Steiner points on cavity boundary are prohibited(-Y switch),
+                so new triangles are conforming with kept ones, and new boundary lines are split before by area constraint.
+                \return false if cavities can't be triangulated separately, e.g. mesh parameters or holes are changed 
+                , area of new triangles doesn't match or their angles are less then half of MeshParams::min_angle,
+                then whole region should be triangulated.
+            */
+            bool remesh_cavities(const Boundary &boundary, const t_PointList &holes);
+
+            ///Converts \ref stored triangulation to quadrangular tethex::FlatMesh.
+            tethex::FlatMesh stored_to_flat() const;
+
             void initialize_mesh_parameters(const MeshParams &mesh_params);
       
         public:
@@ -175,6 +225,9 @@ namespace River
             ///Mesh refinment object
             MeshParams mesh_params;
 
+            ///Time of triangulation and conversion to quadrangles, named as subphases of "MeshGeneration".
+            Timers timers;
+
             Triangle();
             Triangle(MeshParams mesh_params);
             ~Triangle();
@@ -187,5 +240,31 @@ namespace River
              */
             tethex::Mesh generate_quadrangular_mesh(const Boundary &boundary, const t_PointList &holes);
 
+            /**
+             * Generate mesh in flat arrays, which can be passed directly to deal.II.
+             * 
+             * @param boundary Boundary object which holds boundary constrains, and holes etc. 
+             * @param holes Holds hols of region. 
+             */
+            tethex::FlatMesh generate_flat_quadrangular_mesh(const Boundary &boundary, const t_PointList &holes);
+
+            /**
+             * Generate mesh in flat arrays, reusing triangulation of previous call.
+             * 
+             * If MeshParams::remeshing_radius is positive, only triangles around tips and changed boundary lines
+             * are triangulated again and the rest are kept from previous call. Whole region is triangulated 
+             * at first call, each MeshParams::full_remeshing_period calls, or when cavities can't be triangulated separately.
+             * 
+             * @param boundary Boundary object which holds boundary constrains, and holes etc. 
+             * @param holes Holds hols of region. 
+             */
+            tethex::FlatMesh update_flat_quadrangular_mesh(const Boundary &boundary, const t_PointList &holes);
+
+            ///Clears triangulation kept by \ref update_flat_quadrangular_mesh, so next call triangulates whole region.
+            void clear_triangulation();
+
+            ///True if last \ref update_flat_quadrangular_mesh call triangulated only cavities around tips.
+            bool last_update_is_incremental() const;
+
   };
 } //namespace mesh
@@ -335,6 +335,9 @@
 #include <stdlib.h>
 #include <string.h>
 #include <math.h>
+#include <mutex>
+#include <functional>
+#include <string>
 
 #include "triangle_c.hpp"
 
@@ -358,6 +361,8 @@ namespace River{
     write << "\t min_edge = " << mp.min_edge << endl;
     write << "\t ratio = " << mp.ratio << endl;
     write << "\t sigma = " << mp.sigma << endl;
+    write << "\t remeshing_radius = " << mp.remeshing_radius << endl;
+    write << "\t full_remeshing_period = " << mp.full_remeshing_period << endl;
     return write;
   }
 
@@ -365,12 +370,147 @@ namespace River{
   {
     return abs(refinment_radius - mp.refinment_radius) < EPS 
       && abs(exponant - mp.exponant) < EPS 
+      && abs(sigma - mp.sigma) < EPS 
       && abs(min_area - mp.min_area) < EPS 
       && abs(max_area - mp.max_area) < EPS 
       && abs(min_angle - mp.min_angle) < EPS 
       && abs(max_edge - mp.max_edge) < EPS 
       && abs(min_edge - mp.min_edge) < EPS 
-      && abs(ratio - mp.ratio) < EPS;
+      && abs(ratio - mp.ratio) < EPS
+      && abs(remeshing_radius - mp.remeshing_radius) < EPS
+      && full_remeshing_period == mp.full_remeshing_period;
+  }
+
+  double MeshParams::InfluenceRadius() const
+  {
+    if (exponant <= 0)
+      return numeric_limits<double>::infinity();
+
+    auto area_range = max_area - min_area;
+    if (area_range <= 0 || refinment_radius <= 0)
+      return 0;
+
+    //area differs from max_area by 2*area_range*exp_val, which should be below machine epsilon
+    auto log_val = log(2. * area_range / (DBL_EPSILON * max_area));
+    if (log_val <= 0)
+      return 0;
+
+    return refinment_radius * pow(2. * sigma * sigma * log_val, 1. / exponant);
+  }
+
+  void MeshParams::BuildTipsIndex()
+  {
+    ClearTipsIndex();
+    if (tip_points.empty())
+      return;
+
+    double x_min = tip_points.front().x, x_max = x_min,
+      y_min = tip_points.front().y, y_max = y_min;
+    for (const auto &tip : tip_points)
+    {
+      x_min = min(x_min, tip.x);
+      x_max = max(x_max, tip.x);
+      y_min = min(y_min, tip.y);
+      y_max = max(y_max, tip.y);
+    }
+
+    //cell size is chosen so that there is about one tip per cell
+    auto width = x_max - x_min, height = y_max - y_min;
+    tips_index_h = sqrt(max(width * height, width * width + height * height) / tip_points.size());
+    if (tips_index_h <= 0)
+      tips_index_h = 1;
+
+    tips_index_x0 = x_min;
+    tips_index_y0 = y_min;
+    tips_index_nx = (long)floor(width / tips_index_h) + 1;
+    tips_index_ny = (long)floor(height / tips_index_h) + 1;
+
+    //counting sort of tips by cells
+    vector<size_t> cells(tip_points.size());
+    tips_index_start.assign(tips_index_nx * tips_index_ny + 1, 0);
+    for (size_t k = 0; k < tip_points.size(); ++k)
+    {
+      auto [i, j] = tipsIndexCell(tip_points[k].x, tip_points[k].y);
+      cells[k] = j * tips_index_nx + i;
+      ++tips_index_start[cells[k] + 1];
+    }
+    for (size_t c = 1; c < tips_index_start.size(); ++c)
+      tips_index_start[c] += tips_index_start[c - 1];
+
+    auto position = tips_index_start;
+    tips_index_ids.resize(tip_points.size());
+    for (size_t k = 0; k < tip_points.size(); ++k)
+      tips_index_ids[position[cells[k]]++] = k;
+
+    tips_index_hash = TipsHash(tip_points);
+  }
+
+  bool MeshParams::TipsIndexIsValid() const
+  {
+    return hasTipsIndex() && tips_index_hash == TipsHash(tip_points);
+  }
+
+  size_t MeshParams::TipsHash(const t_PointList &tips)
+  {
+    size_t result = tips.size();
+    for (const auto &tip : tips)
+      for (const auto coord : {tip.x, tip.y})
+        result ^= hash<double>{}(coord) + 0x9e3779b9 + (result << 6) + (result >> 2);
+    return result;
+  }
+
+  void MeshParams::ClearTipsIndex()
+  {
+    tips_index_start.clear();
+    tips_index_ids.clear();
+    tips_index_hash = 0;
+    tips_index_nx = tips_index_ny = 0;
+  }
+
+  double MeshParams::NearestTipDistance(double x, double y, double max_distance) const
+  {
+    auto best = numeric_limits<double>::infinity();
+    if (!hasTipsIndex())
+    {
+      for (const auto &tip : tip_points)
+        best = min(best, (Point{x, y} - tip).norm());
+      return best <= max_distance ? best : numeric_limits<double>::infinity();
+    }
+
+    auto [ci, cj] = tipsIndexCell(x, y);
+    auto max_ring = max({ci, tips_index_nx - 1 - ci, cj, tips_index_ny - 1 - cj});
+    for (long ring = 0; ring <= max_ring; ++ring)
+    {
+      auto i_min = ci - ring, i_max = ci + ring, 
+        j_min = cj - ring, j_max = cj + ring;
+
+      //cells on ring perimeter
+      for (auto j = max(j_min, 0l); j <= min(j_max, tips_index_ny - 1); ++j)
+        for (auto i = max(i_min, 0l); i <= min(i_max, tips_index_nx - 1); ++i)
+        {
+          if (j != j_min && j != j_max && i != i_min && i != i_max)
+            continue;
+          auto cell = j * tips_index_nx + i;
+          for (auto k = tips_index_start[cell]; k < tips_index_start[cell + 1]; ++k)
+            best = min(best, (Point{x, y} - tip_points[tips_index_ids[k]]).norm());
+        }
+
+      //lower bound of distance to tips from cells outside of visited square
+      auto bound = numeric_limits<double>::infinity();
+      if (i_min > 0)
+        bound = min(bound, x - (tips_index_x0 + i_min * tips_index_h));
+      if (i_max < tips_index_nx - 1)
+        bound = min(bound, tips_index_x0 + (i_max + 1) * tips_index_h - x);
+      if (j_min > 0)
+        bound = min(bound, y - (tips_index_y0 + j_min * tips_index_h));
+      if (j_max < tips_index_ny - 1)
+        bound = min(bound, tips_index_y0 + (j_max + 1) * tips_index_h - y);
+
+      if (best <= bound || bound > max_distance)
+        break;
+    }
+
+    return best <= max_distance ? best : numeric_limits<double>::infinity();
   }
 }
 
@@ -681,9 +821,10 @@ REAL ccwerrboundA, ccwerrboundB, ccwerrboundC;
 REAL iccerrboundA, iccerrboundB, iccerrboundC;
 REAL o3derrboundA, o3derrboundB, o3derrboundC;
 
-/* Random number seed is not constant, but I've made it global anyway.       */
+/* Random number seed is not constant, so each thread has its own, which     */
+/*   keeps concurrent triangulate() calls reentrant and deterministic.       */
 
-unsigned long randomseed; /* Current random number seed. */
+thread_local unsigned long randomseed; /* Current random number seed. */
 
 /* Mesh data structure.  Triangle operates on only one mesh, but the mesh    */
 /*   structure is used (instead of global variables) to allow reentrancy.    */
@@ -778,6 +919,10 @@ struct mesh
 struct behavior
 {
 
+  /* Mesh refinement parameters used by triunsuitable() (-u switch).           */
+  /*   Carried here instead of global variable to allow reentrancy.            */
+  const River::MeshParams *mesh_params;
+
   /* Switches for the triangulator.                                            */
   /*   poly: -p switch.  refine: -r switch.                                    */
   /*   quality: -q switch.                                                     */
@@ -1399,10 +1544,9 @@ void set_tria_to_default(struct triangulateio *io)
 /*                                                                           */
 /*****************************************************************************/
 
-River::MeshParams *ac_global = NULL;
-int triunsuitable(vertex triorg, vertex tridest, vertex triapex, REAL area)
+int triunsuitable(struct behavior *b, vertex triorg, vertex tridest, vertex triapex, REAL area)
 {
-  return (int)ac_global->refinementFunction(
+  return (int)b->mesh_params->refinementFunction(
     River::Point{(double)triorg[0], (double)triorg[1]}, 
     River::Point{(double)tridest[0], (double)tridest[1]},
     River::Point{(double)triapex[0], (double)triapex[1]},
@@ -1419,7 +1563,8 @@ int triunsuitable(vertex triorg, vertex tridest, vertex triapex, REAL area)
 
 void triexit(int status)
 {
-  exit(status);
+  /* Error is propagated to caller instead of exit of whole process. */
+  throw River::Exception("Triangle: mesh generation failed with status " + std::to_string(status));
 }
 
 VOID *trimalloc(int size)
@@ -4701,9 +4846,33 @@ void triangleinit(struct mesh *m)
   m->checkquality = 0;                 /* The quality triangulation stage has not begun. */
   m->incirclecount = m->counterclockcount = m->orient3dcount = 0;
   m->hyperbolacount = m->circletopcount = m->circumcentercount = 0;
+  m->dummytribase = (triangle *)NULL;
+  m->dummysubbase = (subseg *)NULL;
   randomseed = 1;
 
-  exactinit(); /* Initialize exact arithmetic constants. */
+  /* Exact arithmetic constants are global, so they are initialized once. */
+  static std::once_flag exactinit_flag;
+  std::call_once(exactinit_flag, exactinit);
+}
+
+/*****************************************************************************/
+/*                                                                           */
+/*  triangleabort()   Free all memory of partially built mesh after error.   */
+/*                                                                           */
+/*****************************************************************************/
+
+void triangleabort(struct mesh *m)
+{
+  pooldeinit(&m->triangles);
+  pooldeinit(&m->subsegs);
+  pooldeinit(&m->vertices);
+  pooldeinit(&m->viri);
+  pooldeinit(&m->badsubsegs);
+  pooldeinit(&m->badtriangles);
+  pooldeinit(&m->flipstackers);
+  pooldeinit(&m->splaynodes);
+  trifree((VOID *)m->dummytribase);
+  trifree((VOID *)m->dummysubbase);
 }
 
 /*****************************************************************************/
@@ -5142,7 +5311,7 @@ void testtriangle(struct mesh *m, struct behavior *b, struct otri *testtri)
     if (b->usertest)
     {
       /* Check whether the user thinks this triangle is too large. */
-      if (triunsuitable(torg, tdest, tapex, area))
+      if (triunsuitable(b, torg, tdest, tapex, area))
       {
         enqueuebadtri(m, b, testtri, minedge, tapex, torg, tdest);
         return;
@@ -11374,52 +11543,26 @@ void statistics(struct mesh *m, struct behavior *b)
 
 /*****************************************************************************/
 /*                                                                           */
-/*  main() or triangulate()   Gosh, do everything.                           */
-/*                                                                           */
-/*  The sequence is roughly as follows.  Many of these steps can be skipped, */
-/*  depending on the command line switches.                                  */
-/*                                                                           */
-/*  - Initialize constants and parse the command line.                       */
-/*  - Read the vertices from a file and either                               */
-/*    - triangulate them (no -r), or                                         */
-/*    - read an old mesh from files and reconstruct it (-r).                 */
-/*  - Insert the PSLG segments (-p), and possibly segments on the convex     */
-/*      hull (-c).                                                           */
-/*  - Read the holes (-p), regional attributes (-pA), and regional area      */
-/*      constraints (-pa).  Carve the holes and concavities, and spread the  */
-/*      regional attributes and area constraints.                            */
-/*  - Enforce the constraints on minimum angle (-q) and maximum area (-a).   */
-/*      Also enforce the conforming Delaunay property (-q and -a).           */
-/*  - Compute the number of edges in the resulting mesh.                     */
-/*  - Promote the mesh's linear triangles to higher order elements (-o).     */
-/*  - Write the output files and print the statistics.                       */
-/*  - Check the consistency and Delaunay property of the mesh (-C).          */
+/*  triangulatemesh()   Do all steps of triangulate() on initialized mesh    */
+/*                      and behavior.  Errors are thrown as exceptions.      */
 /*                                                                           */
 /*****************************************************************************/
 
-void triangulate(const char *triswitches, struct triangulateio *in,
-                 struct triangulateio *out, struct triangulateio *vorout, River::MeshParams *ac)
+void triangulatemesh(struct mesh *m, struct behavior *b, struct triangulateio *in,
+                     struct triangulateio *out, struct triangulateio *vorout)
 {
-  struct mesh m;
-  struct behavior b;
   REAL *holearray;   /* Array of holes. */
   REAL *regionarray; /* Array of regional attributes and area constraints. */
 
-  ac_global = ac;
-
-  triangleinit(&m);
-  parsecommandline(1, &triswitches, &b);
-  m.steinerleft = b.steiner;
-
-  transfernodes(&m, &b, in->pointlist, in->pointattributelist,
+  transfernodes(m, b, in->pointlist, in->pointattributelist,
                 in->pointmarkerlist, in->numberofpoints,
                 in->numberofpointattributes);
 
-  if (b.refine)
+  if (b->refine)
   {
     /* Read and reconstruct a mesh. */
 
-    m.hullsize = reconstruct(&m, &b, in->trianglelist,
+    m->hullsize = reconstruct(m, b, in->trianglelist,
                              in->triangleattributelist, in->trianglearealist,
                              in->numberoftriangles, in->numberofcorners,
                              in->numberoftriangleattributes,
@@ -11428,36 +11571,36 @@ void triangulate(const char *triswitches, struct triangulateio *in,
   }
   else
   {
-    m.hullsize = delaunay(&m, &b); /* Triangulate the vertices. */
+    m->hullsize = delaunay(m, b); /* Triangulate the vertices. */
   }
 
   /* Ensure that no vertex can be mistaken for a triangular bounding */
   /*   box vertex in insertvertex().                                 */
-  m.infvertex1 = (vertex)NULL;
-  m.infvertex2 = (vertex)NULL;
-  m.infvertex3 = (vertex)NULL;
+  m->infvertex1 = (vertex)NULL;
+  m->infvertex2 = (vertex)NULL;
+  m->infvertex3 = (vertex)NULL;
 
-  if (b.usesegments)
+  if (b->usesegments)
   {
-    m.checksegments = 1; /* Segments will be introduced next. */
-    if (!b.refine)
+    m->checksegments = 1; /* Segments will be introduced next. */
+    if (!b->refine)
     {
       /* Insert PSLG segments and/or convex hull segments. */
-      formskeleton(&m, &b, in->segmentlist,
+      formskeleton(m, b, in->segmentlist,
                    in->segmentmarkerlist, in->numberofsegments);
     }
   }
 
-  if (b.poly && (m.triangles.items > 0))
+  if (b->poly && (m->triangles.items > 0))
   {
     holearray = in->holelist;
-    m.holes = in->numberofholes;
+    m->holes = in->numberofholes;
     regionarray = in->regionlist;
-    m.regions = in->numberofregions;
-    if (!b.refine)
+    m->regions = in->numberofregions;
+    if (!b->refine)
     {
       /* Carve out holes and concavities. */
-      carveholes(&m, &b, holearray, m.holes, regionarray, m.regions);
+      carveholes(m, b, holearray, m->holes, regionarray, m->regions);
     }
   }
   else
@@ -11465,99 +11608,99 @@ void triangulate(const char *triswitches, struct triangulateio *in,
     /* Without a PSLG, there can be no holes or regional attributes   */
     /*   or area constraints.  The following are set to zero to avoid */
     /*   an accidental free() later.                                  */
-    m.holes = 0;
-    m.regions = 0;
+    m->holes = 0;
+    m->regions = 0;
   }
 
-  if (b.quality && (m.triangles.items > 0))
+  if (b->quality && (m->triangles.items > 0))
   {
-    enforcequality(&m, &b); /* Enforce angle and area constraints. */
+    enforcequality(m, b); /* Enforce angle and area constraints. */
   }
 
   /* Calculate the number of edges. */
-  m.edges = (3l * m.triangles.items + m.hullsize) / 2l;
+  m->edges = (3l * m->triangles.items + m->hullsize) / 2l;
 
-  if (b.order > 1)
+  if (b->order > 1)
   {
-    highorder(&m, &b); /* Promote elements to higher polynomial order. */
+    highorder(m, b); /* Promote elements to higher polynomial order. */
   }
-  if (!b.quiet)
+  if (!b->quiet)
   {
     printf("\n");
   }
 
-  if (b.jettison)
+  if (b->jettison)
   {
-    out->numberofpoints = m.vertices.items - m.undeads;
+    out->numberofpoints = m->vertices.items - m->undeads;
   }
   else
   {
-    out->numberofpoints = m.vertices.items;
+    out->numberofpoints = m->vertices.items;
   }
-  out->numberofpointattributes = m.nextras;
-  out->numberoftriangles = m.triangles.items;
-  out->numberofcorners = (b.order + 1) * (b.order + 2) / 2;
-  out->numberoftriangleattributes = m.eextras;
-  out->numberofedges = m.edges;
-  if (b.usesegments)
+  out->numberofpointattributes = m->nextras;
+  out->numberoftriangles = m->triangles.items;
+  out->numberofcorners = (b->order + 1) * (b->order + 2) / 2;
+  out->numberoftriangleattributes = m->eextras;
+  out->numberofedges = m->edges;
+  if (b->usesegments)
   {
-    out->numberofsegments = m.subsegs.items;
+    out->numberofsegments = m->subsegs.items;
   }
   else
   {
-    out->numberofsegments = m.hullsize;
+    out->numberofsegments = m->hullsize;
   }
   if (vorout != (struct triangulateio *)NULL)
   {
-    vorout->numberofpoints = m.triangles.items;
-    vorout->numberofpointattributes = m.nextras;
-    vorout->numberofedges = m.edges;
+    vorout->numberofpoints = m->triangles.items;
+    vorout->numberofpointattributes = m->nextras;
+    vorout->numberofedges = m->edges;
   }
   /* If not using iteration numbers, don't write a .node file if one was */
   /*   read, because the original one would be overwritten!              */
-  if (b.nonodewritten || (b.noiterationnum && m.readnodefile))
+  if (b->nonodewritten || (b->noiterationnum && m->readnodefile))
   {
-    if (!b.quiet)
+    if (!b->quiet)
     {
       printf("NOT writing vertices.\n");
     }
-    numbernodes(&m, &b); /* We must remember to number the vertices. */
+    numbernodes(m, b); /* We must remember to number the vertices. */
   }
   else
   {
     /* writenodes() numbers the vertices too. */
-    writenodes(&m, &b, &out->pointlist, &out->pointattributelist,
+    writenodes(m, b, &out->pointlist, &out->pointattributelist,
                &out->pointmarkerlist);
   }
-  if (b.noelewritten)
+  if (b->noelewritten)
   {
-    if (!b.quiet)
+    if (!b->quiet)
     {
       printf("NOT writing triangles.\n");
     }
   }
   else
   {
-    writeelements(&m, &b, &out->trianglelist, &out->triangleattributelist);
+    writeelements(m, b, &out->trianglelist, &out->triangleattributelist);
   }
   /* The -c switch (convex switch) causes a PSLG to be written */
   /*   even if none was read.                                  */
-  if (b.poly || b.convex)
+  if (b->poly || b->convex)
   {
     /* If not using iteration numbers, don't overwrite the .poly file. */
-    if (b.nopolywritten || b.noiterationnum)
+    if (b->nopolywritten || b->noiterationnum)
     {
-      if (!b.quiet)
+      if (!b->quiet)
       {
         printf("NOT writing segments.\n");
       }
     }
     else
     {
-      writepoly(&m, &b, &out->segmentlist, &out->segmentmarkerlist);
-      out->numberofholes = m.holes;
-      out->numberofregions = m.regions;
-      if (b.poly)
+      writepoly(m, b, &out->segmentlist, &out->segmentmarkerlist);
+      out->numberofholes = m->holes;
+      out->numberofregions = m->regions;
+      if (b->poly)
       {
         out->holelist = in->holelist;
         out->regionlist = in->regionlist;
@@ -11570,24 +11713,82 @@ void triangulate(const char *triswitches, struct triangulateio *in,
     }
   }
 
-  if (b.edgesout)
+  if (b->edgesout)
   {
-    writeedges(&m, &b, &out->edgelist, &out->edgemarkerlist);
+    writeedges(m, b, &out->edgelist, &out->edgemarkerlist);
   }
-  if (b.voronoi)
+  if (b->voronoi)
   {
-    writevoronoi(&m, &b, &vorout->pointlist, &vorout->pointattributelist,
+    writevoronoi(m, b, &vorout->pointlist, &vorout->pointattributelist,
                  &vorout->pointmarkerlist, &vorout->edgelist,
                  &vorout->edgemarkerlist, &vorout->normlist);
   }
-  if (b.neighbors)
+  if (b->neighbors)
   {
-    writeneighbors(&m, &b, &out->neighborlist);
+    writeneighbors(m, b, &out->neighborlist);
   }
 
-  if (!b.quiet)
+  if (!b->quiet)
+  {
+    statistics(m, b);
+  }
+}
+
+/*****************************************************************************/
+/*                                                                           */
+/*  main() or triangulate()   Gosh, do everything.                           */
+/*                                                                           */
+/*  The sequence is roughly as follows.  Many of these steps can be skipped, */
+/*  depending on the command line switches.                                  */
+/*                                                                           */
+/*  - Initialize constants and parse the command line.                       */
+/*  - Read the vertices from a file and either                               */
+/*    - triangulate them (no -r), or                                         */
+/*    - read an old mesh from files and reconstruct it (-r).                 */
+/*  - Insert the PSLG segments (-p), and possibly segments on the convex     */
+/*      hull (-c).                                                           */
+/*  - Read the holes (-p), regional attributes (-pA), and regional area      */
+/*      constraints (-pa).  Carve the holes and concavities, and spread the  */
+/*      regional attributes and area constraints.                            */
+/*  - Enforce the constraints on minimum angle (-q) and maximum area (-a).   */
+/*      Also enforce the conforming Delaunay property (-q and -a).           */
+/*  - Compute the number of edges in the resulting mesh.                     */
+/*  - Promote the mesh's linear triangles to higher order elements (-o).     */
+/*  - Write the output files and print the statistics.                       */
+/*  - Check the consistency and Delaunay property of the mesh (-C).          */
+/*                                                                           */
+/*****************************************************************************/
+
+void triangulate(const char *triswitches, struct triangulateio *in,
+                 struct triangulateio *out, struct triangulateio *vorout, const River::MeshParams *ac)
+{
+  struct mesh m;
+  struct behavior b;
+  /* Tips index is checked once and, if needed, built in own copy, so caller's parameters aren't changed.  */
+  River::MeshParams indexed_params;
+
+  triangleinit(&m);
+  parsecommandline(1, &triswitches, &b);
+  b.mesh_params = ac;
+  if (b.usertest && ac == NULL)
+    throw River::Exception("Triangle: -u switch needs mesh parameters.");
+  if (b.usertest && !ac->TipsIndexIsValid())
+  {
+    indexed_params = *ac;
+    indexed_params.BuildTipsIndex();
+    b.mesh_params = &indexed_params;
+  }
+  m.steinerleft = b.steiner;
+
+  try
+  {
+    triangulatemesh(&m, &b, in, out, vorout);
+  }
+  catch (...)
   {
-    statistics(&m, &b);
+    /* Free memory of partially built mesh and pass error to caller. */
+    triangleabort(&m);
+    throw;
   }
 
   triangledeinit(&m, &b);
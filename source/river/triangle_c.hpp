@@ -23,7 +23,9 @@ typedef long double longdouble;
 
 #include <vector>
 #include <cmath>
+#include <algorithm>
 #include <float.h>
+#include <limits>
 
 ///\endcond
 
@@ -88,14 +90,24 @@ namespace River
         \todo handle edge values of ration which will correspond to 35 degree.
     */
     double ratio = 2.3;
+
+    /*! \brief Radius of incremental remeshing.
+        \details If it is positive, then at each step only triangles closer then this radius to tips 
+        or changed boundary lines are triangulated again, see \ref River::Triangle::update_flat_quadrangular_mesh.
+        Zero value disables incremental remeshing.
+    */
+    double remeshing_radius = 0;
+
+    /// Number of incremental remeshing steps after which whole region is triangulated again. Zero value means no limit.
+    unsigned full_remeshing_period = 10;
     
     // functionality to calculate if the point is inside of triangle or outside..
-    inline double sign (const River::Point &p1, const River::Point &p2, const River::Point &p3)
+    inline double sign (const River::Point &p1, const River::Point &p2, const River::Point &p3) const
     {
         return (p1.x - p3.x) * (p2.y - p3.y) - (p2.x - p3.x) * (p1.y - p3.y);
     }
 
-    inline bool PointInTriangle(const River::Point &pt, const River::Point &p1, const River::Point &p2, const River::Point &p3)
+    inline bool PointInTriangle(const River::Point &pt, const River::Point &p1, const River::Point &p2, const River::Point &p3) const
     {
         double d1, d2, d3;
         bool has_neg, has_pos;
@@ -111,7 +123,7 @@ namespace River
     }
 
     /// Specifies a function to indicate whether mesh cells should be refined or not.
-    bool refinementFunction(const River::Point & p1, const River::Point & p2, const River::Point & p3, const double &area)
+    bool refinementFunction(const River::Point & p1, const River::Point & p2, const River::Point & p3, const double &area) const
     {
       // evaluatio of edge lenghts
       // lengths are of the first priority
@@ -152,24 +164,60 @@ namespace River
         return true;
 
       //constrain triangle area in better way
-      for(const auto& tip_point: tip_points)
-        if (PointInTriangle(tip_point, p1, p2, p3) && meshAreaConstraint(tip_point.x, tip_point.y) < area
-          && min_dl > min_edge && area > min_area)
-          return true;
+      if (min_dl <= min_edge || area <= min_area)
+        return false;
+
+      if (!hasTipsIndex())
+      {
+        for(const auto& tip_point: tip_points)
+          if (PointInTriangle(tip_point, p1, p2, p3) && meshAreaConstraint(tip_point.x, tip_point.y) < area)
+            return true;
+        return false;
+      }
+
+      //only tips from cells overlapped by triangle bounding box are tested
+      auto [i_min, j_min] = tipsIndexCell(std::min({p1.x, p2.x, p3.x}), std::min({p1.y, p2.y, p3.y}));
+      auto [i_max, j_max] = tipsIndexCell(std::max({p1.x, p2.x, p3.x}), std::max({p1.y, p2.y, p3.y}));
+      for (long j = j_min; j <= j_max; ++j)
+        for (long i = i_min; i <= i_max; ++i)
+        {
+          auto cell = j * tips_index_nx + i;
+          for (auto k = tips_index_start[cell]; k < tips_index_start[cell + 1]; ++k)
+          {
+            const auto& tip_point = tip_points[tips_index_ids[k]];
+            if (PointInTriangle(tip_point, p1, p2, p3) && meshAreaConstraint(tip_point.x, tip_point.y) < area)
+              return true;
+          }
+        }
 
       return false;
     };
 
+    /*! \brief Mesh area constraint at distance \p r from single tip.
+        \details Function is non decreasing with \p r, so only nearest tip defines area constraint.
+    */
+    inline double areaAtDistance(double r) const
+    {
+      auto exp_val = exp(-pow(r / refinment_radius, exponant) / 2. / sigma / sigma);
+      return min_area + (max_area - min_area) * (1. - exp_val) / (1. + exp_val);
+    }
+
     /*! \brief Evaluates mesh area constraint at {x, y} point.
+        \details Uses index of tip points if it is built(see \ref River::MeshParams::BuildTipsIndex), 
+        otherwise loops over all tips.
     */
     inline double meshAreaConstraint(double x, double y) const
     {
+      if (hasTipsIndex())
+      {
+        auto r = NearestTipDistance(x, y, InfluenceRadius());
+        return r < std::numeric_limits<double>::infinity() ? std::min(max_area, areaAtDistance(r)) : max_area;
+      }
+
       double result_area = max_area;
       for (auto &tip : tip_points)
       {
-        auto r = (River::Point{x, y} - tip).norm();
-        auto exp_val = exp(-pow(r / refinment_radius, exponant) / 2. / sigma / sigma);
-        auto cur_area = min_area + (max_area - min_area) * (1. - exp_val) / (1. + exp_val);
+        auto cur_area = areaAtDistance((River::Point{x, y} - tip).norm());
         if (result_area > cur_area)
           result_area = cur_area;
       }
@@ -177,10 +225,70 @@ namespace River
       return result_area;
     }
 
+    /*! \brief Distance beyond which tip doesn't change mesh area constraint.
+        \details At this distance area differs from \ref River::MeshParams::max_area less then by machine epsilon.
+    */
+    double InfluenceRadius() const;
+
+    /*! \brief Builds uniform grid index over \ref River::MeshParams::tip_points.
+        \details triangulate() checks it once and, if it isn't valid, builds it in its own copy of parameters, so it is
+        needed only for direct calls of area constraint. If tip points are changed after this call, index should be rebuilt.
+    */
+    void BuildTipsIndex();
+
+    /// Removes index of tip points, so brute force loop over tips is used.
+    void ClearTipsIndex();
+
+    /*! \brief Returns true if index is built for current tip points.
+        \details Number and hash of tip points are compared with ones stored by \ref River::MeshParams::BuildTipsIndex.
+        Check loops over tips, so it is done once per triangulation, while area constraint queries only check that index is built.
+    */
+    bool TipsIndexIsValid() const;
+
+    /*! \brief Distance from {x, y} to nearest tip point.
+        \details Tips further then \p max_distance are ignored.
+        \return infinity if there is no tips closer then \p max_distance.
+    */
+    double NearestTipDistance(double x, double y, 
+      double max_distance = std::numeric_limits<double>::infinity()) const;
+
     /// Prints program options structure to output stream.
     friend ostream &operator<<(ostream &write, const MeshParams &mp);
 
     bool operator==(const MeshParams &mp) const;
+
+  private:
+    ///@{
+    /*! \brief Uniform grid index of tip points.
+        \details Tip ids of cell {i, j} are stored in tips_index_ids in range 
+        [tips_index_start[j*nx + i], tips_index_start[j*nx + i + 1]).
+    */
+    double tips_index_x0 = 0, tips_index_y0 = 0, tips_index_h = 1;
+    long tips_index_nx = 0, tips_index_ny = 0;
+    vector<size_t> tips_index_start;
+    vector<size_t> tips_index_ids;
+    /// Hash of tip points for which index was built.
+    size_t tips_index_hash = 0;
+    ///@}
+
+    /// Hash of coordinates of \p tips.
+    static size_t TipsHash(const t_PointList &tips);
+
+    /*! \brief Returns true if index is built for same number of tips as current ones.
+        \details Constant time check used by area constraint queries, see \ref River::MeshParams::TipsIndexIsValid.
+    */
+    inline bool hasTipsIndex() const
+    {
+      return !tips_index_start.empty() && tips_index_ids.size() == tip_points.size();
+    }
+
+    /// Index of cell which contains {x, y}, points outside of grid are clamped to nearest cell.
+    inline pair<long, long> tipsIndexCell(double x, double y) const
+    {
+      auto i = (long)floor((x - tips_index_x0) / tips_index_h),
+        j = (long)floor((y - tips_index_y0) / tips_index_h);
+      return {std::clamp(i, 0l, tips_index_nx - 1), std::clamp(j, 0l, tips_index_ny - 1)};
+    }
   };
 }
 
@@ -503,9 +611,13 @@ struct triangulateio
 
     Certain fields of the input and output structures must be initialized,
     as described above.
+
+    This function is reentrant: all state lives in per call structures,
+    so it can be called concurrently from different threads. Errors are
+    reported by throwing River::Exception instead of exiting the process.
 */
 void triangulate(const char *, struct triangulateio *, struct triangulateio *,
-                 struct triangulateio *, River::MeshParams *ac = NULL); //
+                 struct triangulateio *, const River::MeshParams *ac = NULL); //
 
 /// Free memory.
 void trifree(void *memptr);
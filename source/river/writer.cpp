@@ -0,0 +1,107 @@
+/*
+ * riversim - river growth simulation.
+ * Copyright (c) 2019 Oleg Kmechak
+ * Report issues: github.com/okmechak/RiverSim/issues
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ */
+
+#include "writer.hpp"
+
+namespace River
+{
+    AsyncWriter::~AsyncWriter()
+    {
+        {
+            lock_guard<mutex> lock(jobs_mutex);
+            is_stopped = true;
+        }
+        job_pushed.notify_all();
+        if (worker.joinable())
+            worker.join();
+    }
+
+    void AsyncWriter::push(t_job job)
+    {
+        if (max_queue_size == 0)
+        {
+            job();
+            return;
+        }
+
+        unique_lock<mutex> lock(jobs_mutex);
+        rethrow_error();
+        if (!worker.joinable())
+            worker = thread(&AsyncWriter::work, this);
+
+        job_done.wait(lock, [this]{ return jobs.size() < max_queue_size; });
+        jobs.push(move(job));
+        lock.unlock();
+        job_pushed.notify_one();
+    }
+
+    void AsyncWriter::wait()
+    {
+        unique_lock<mutex> lock(jobs_mutex);
+        job_done.wait(lock, [this]{ return jobs.empty() && !is_job_running; });
+        rethrow_error();
+    }
+
+    size_t AsyncWriter::size()
+    {
+        lock_guard<mutex> lock(jobs_mutex);
+        return jobs.size() + is_job_running;
+    }
+
+    void AsyncWriter::work()
+    {
+        unique_lock<mutex> lock(jobs_mutex);
+        while (true)
+        {
+            job_pushed.wait(lock, [this]{ return is_stopped || !jobs.empty(); });
+            // queue is emptied before stop, so all pushed files are written
+            if (jobs.empty())
+                return;
+
+            auto job = move(jobs.front());
+            jobs.pop();
+            is_job_running = true;
+            lock.unlock();
+            // place in queue is free
+            job_done.notify_all();
+
+            exception_ptr job_error;
+            try
+            {
+                job();
+            }
+            catch (...)
+            {
+                job_error = current_exception();
+            }
+
+            lock.lock();
+            is_job_running = false;
+            if (job_error && !error)
+                error = job_error;
+            job_done.notify_all();
+        }
+    }
+
+    void AsyncWriter::rethrow_error()
+    {
+        if (error)
+        {
+            auto e = error;
+            error = nullptr;
+            rethrow_exception(e);
+        }
+    }
+}
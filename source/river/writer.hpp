@@ -0,0 +1,92 @@
+/*
+    riversim - river growth simulation.
+    Copyright (c) 2019 Oleg Kmechak
+    Report issues: github.com/okmechak/RiverSim/issues
+
+    This program is free software; you can redistribute it and/or
+    modify it under the terms of the GNU General Public License
+    as published by the Free Software Foundation; either version 2
+    of the License, or (at your option) any later version.
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+    GNU General Public License for more details.
+ */
+
+/*! \file writer.hpp
+    \brief Background writer of output files.
+    \details River::RiverSolver takes cheap snapshot of data(copy of River::Model, patches of solution) and
+    passes writing of it to River::AsyncWriter, so serialization and file output of one step run concurrently
+    with meshing and solution of next step.
+ */
+#pragma once
+
+///\cond
+#include <queue>
+#include <mutex>
+#include <thread>
+#include <functional>
+#include <exception>
+#include <condition_variable>
+///\endcond
+
+using namespace std;
+
+namespace River
+{
+    /*! \brief Runs jobs one by one in background thread in order of their push.
+        \details Number of queued jobs is bounded by max_queue_size, so push() blocks while queue is full, and
+        memory held by snapshots is capped. If max_queue_size is zero, jobs are run by push() itself.
+        Exception thrown by job is rethrown by next call of push() or wait(), following jobs are still run.
+    */
+    class AsyncWriter
+    {
+        public:
+            typedef function<void()> t_job;
+
+            explicit AsyncWriter(const unsigned max_queue_size = 2):
+                max_queue_size{max_queue_size}
+            {}
+
+            AsyncWriter(const AsyncWriter&) = delete;
+            AsyncWriter& operator=(const AsyncWriter&) = delete;
+
+            ///Waits for all queued jobs and stops thread, errors of jobs are ignored.
+            ~AsyncWriter();
+
+            ///Queues \p job, thread is started at first push.
+            void push(t_job job);
+
+            ///Blocks till all queued jobs are done.
+            void wait();
+
+            ///Number of queued and running jobs.
+            size_t size();
+
+            unsigned get_max_queue_size() const { return max_queue_size; }
+
+        private:
+            ///Loop of background thread.
+            void work();
+
+            ///Rethrows and resets error of job, mutex should be locked.
+            void rethrow_error();
+
+            const unsigned max_queue_size;
+
+            queue<t_job> jobs;
+
+            ///True while job taken from queue is run.
+            bool is_job_running = false;
+
+            bool is_stopped = false;
+
+            exception_ptr error;
+
+            mutex jobs_mutex;
+
+            condition_variable job_pushed, job_done;
+
+            thread worker;
+    };
+}
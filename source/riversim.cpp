@@ -129,6 +129,15 @@
     And after that, typical backward simulation commnad:
     > ./riversim -n 130 -o revsim --simulation-type=1 simdata.json
 
+    Ensemble of independent simulations(see River::RunEnsemble) in one process:
+    > ./riversim -n 100 -o ensemble --ensemble runs.json
+    where runs.json is e.g.:
+    > {"threads": 8, "runs": [{"model": {"eta": 0.5}}, {"model": {"eta": 1.0}, "output": "eta_1"}]}
+
+    Big meshes can be solved by several MPI processes(see River::DistributedSolver, needs Deal.II with p4est and Trilinos):
+    > mpirun -np 4 ./riversim -n 100 -o simdata
+    All processes simulate same rivers, only root process prints messages and writes output files.
+
     \section team Team
 
     + student Oleg Kmechak
@@ -163,10 +172,22 @@
 */
 int main(int argc, char *argv[])
 {
+    // threads are shared between MPI processes of one node
+    Utilities::MPI::MPI_InitFinalize mpi_initialization(argc, argv);
+
     auto po = River::process_program_options(argc, argv);
 
     if (po.count("help") || po.count("version"))
         return 0;
+
+    if (po.count("ensemble"))
+        return River::RunEnsemble(po);
+
     River::RiverSolver river_solver(po);
+
+    // thread limit is process wide, so it is set once here and not by solvers
+    if (river_solver.model.solver_params.num_of_threads > 0)
+        dealii::MultithreadInfo::set_thread_limit(river_solver.model.solver_params.num_of_threads);
+
     return river_solver.run();
 }
\ No newline at end of file
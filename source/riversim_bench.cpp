@@ -0,0 +1,268 @@
+/*
+    riversim - river growth simulation.
+    Copyright (c) 2019 Oleg Kmechak
+    Report issues: github.com/okmechak/RiverSim/issues
+
+    This program is free software; you can redistribute it and/or
+    modify it under the terms of the GNU General Public License
+    as published by the Free Software Foundation; either version 2
+    of the License, or (at your option) any later version.
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+    GNU General Public License for more details.
+*/
+
+/*!
+    \file riversim_bench.cpp
+    \brief Benchmarks of growth step stages.
+    \details Each stage of growth step(boundary generation, mesh generation, tethex conversion, solution,
+    integration of series parameters and saving/opening of JSON) is measured on synthetic tree of
+    River::Rivers::GrowTestTree branches of increasing size. Each measurement is run once as warm up and
+    then repeated, and minimal, median and mean wall times together with time of subphases(see River::Timers)
+    are printed as JSON, so results of different versions can be compared.
+
+    Usage:
+        ./riversim_bench --repeats 5 --max-depth 6 --max-refinments 2 -o bench.json
+*/
+
+///\cond
+#include <thread>
+#include <cstdio>
+#include <fstream>
+#include <iomanip>
+#include <numeric>
+#include <algorithm>
+///\endcond
+
+#include "riversolver.hpp"
+
+using namespace River;
+
+///Grows binary tree of \p depth levels from branch \p branch_id, length of branches is halved at each level.
+void GrowTree(Rivers &rivers, const t_boundary_id boundary_id, const t_branch_id branch_id, const unsigned depth, const double ds)
+{
+    auto [left_id, right_id] = rivers.GrowTestTree(boundary_id, branch_id, ds, 3, 0);
+    if (depth > 1)
+    {
+        GrowTree(rivers, boundary_id, left_id, depth - 1, ds / 2);
+        GrowTree(rivers, boundary_id, right_id, depth - 1, ds / 2);
+    }
+}
+
+///Laplace model in unit square with tree of 2^\p depth tips growing from middle of bottom side.
+Model TreeModel(const unsigned depth)
+{
+    Model model;
+    model.dx = 0.5;
+    model.InitializeLaplace();
+    GrowTree(model.rivers, model.river_boundary_id, model.sources.begin()->first, depth, 0.04);
+    model.boundary = BoundaryGenerator(
+        model.sources, model.region, model.rivers, model.river_width,
+        model.mesh_params.smoothness_degree, model.mesh_params.ignored_smoothness_length);
+    return model;
+}
+
+/*! \brief Runs \p function once as warm up and \p repeats times more, returns statistics of wall time and mean time of subphases.
+    \details If \p phase is set, statistics are of time of this subphase instead of wall time of \p function.
+*/
+template<typename Function>
+json Measure(const string &name, const json &parameters, const unsigned repeats, Function function, const string &phase = "")
+{
+    Timers timers;
+    function(timers);
+    timers.clear();
+
+    vector<double> times;
+    for (unsigned i = 0; i < repeats; ++i)
+    {
+        Timers run_timers;
+        const auto start = chrono::steady_clock::now();
+        function(run_timers);
+        times.push_back(phase.empty() ? 
+            chrono::duration<double>(chrono::steady_clock::now() - start).count() : 
+            run_timers.phases.at(phase).total_time);
+        timers += run_timers;
+    }
+    sort(times.begin(), times.end());
+
+    json phases = json::object();
+    for (const auto &[phase_name, phase]: timers.phases)
+        phases[phase_name] = phase.total_time / repeats;
+
+    const auto n = times.size();
+    json result = {
+        {"name", name},
+        {"parameters", parameters},
+        {"repeats", repeats},
+        {"min", times.front()},
+        {"median", n % 2 ? times[n / 2] : (times[n / 2 - 1] + times[n / 2]) / 2},
+        {"mean", accumulate(times.begin(), times.end(), 0.) / n},
+        {"phases", phases}};
+
+    cerr << name << " " << parameters.dump() << ": " << result["median"].get<double>() << " s" << endl;
+    return result;
+}
+
+int main(int argc, char *argv[])
+{
+    using namespace cxxopts;
+
+    Options options("./riversim_bench", ProgramTitle() + " v" + version_string() + " benchmarks of growth step stages.\n");
+    options.add_options()
+        ("h,help", "Produce help message.")
+        ("r,repeats", "Number of measured runs of each benchmark.", value<unsigned>()->default_value("5"))
+        ("d,max-depth", "Maximal depth of test tree, number of tips is 2^depth.", value<unsigned>()->default_value("6"))
+        ("s,max-refinments", "Maximal number of static refinments in solver benchmark.", value<unsigned>()->default_value("2"))
+        ("o,output", "Output JSON file, standard output if empty.", value<string>()->default_value(""));
+
+    try
+    {
+        auto po = options.parse(argc, argv);
+        if (po.count("help"))
+        {
+            cout << options.help() << endl;
+            return 0;
+        }
+
+        const auto repeats = max(po["repeats"].as<unsigned>(), 1u);
+        const auto max_depth = max(po["max-depth"].as<unsigned>(), 1u);
+        const auto max_refinments = po["max-refinments"].as<unsigned>();
+
+        json benchmarks = json::array();
+
+        for (unsigned depth = 1; depth <= max_depth; ++depth)
+        {
+            const auto model = TreeModel(depth);
+            const auto tips = model.rivers.TipPoints();
+            const json parameters = {{"depth", depth}, {"tips", tips.size()}, {"boundary_vertices", model.boundary.vertices.size()}};
+
+            benchmarks.push_back(Measure("boundary_generation", parameters, repeats, [&model](Timers &)
+            {
+                auto boundary = BoundaryGenerator(
+                    model.sources, model.region, model.rivers, model.river_width,
+                    model.mesh_params.smoothness_degree, model.mesh_params.ignored_smoothness_length);
+            }));
+
+            Triangle triangle(model.mesh_params);
+            triangle.mesh_params.tip_points = tips;
+            auto quadrangles = triangle.generate_flat_quadrangular_mesh(model.boundary, model.region.holes).get_n_quadrangles();
+            auto mesh_parameters = parameters;
+            mesh_parameters["quadrangles"] = quadrangles;
+
+            benchmarks.push_back(Measure("mesh_generation", mesh_parameters, repeats, [&model, &triangle](Timers &timers)
+            {
+                triangle.timers.clear();
+                triangle.generate_flat_quadrangular_mesh(model.boundary, model.region.holes);
+                timers += triangle.timers;
+            }));
+
+            //triangulation is repeated too, but only its conversion to tethex::Mesh is measured
+            benchmarks.push_back(Measure("tethex_conversion", mesh_parameters, repeats, [&model, &triangle](Timers &timers)
+            {
+                triangle.timers.clear();
+                triangle.generate_quadrangular_mesh(model.boundary, model.region.holes);
+                timers += triangle.timers;
+            }, "MeshGeneration/Conversion"));
+        }
+
+        //solver and integration on tree of middle size
+        const auto model = TreeModel(min(max_depth, 3u));
+        const auto tips = model.rivers.TipPoints();
+        Triangle triangle(model.mesh_params);
+        triangle.mesh_params.tip_points = tips;
+        const auto mesh = triangle.generate_flat_quadrangular_mesh(model.boundary, model.region.holes);
+
+        for (unsigned refinments = 0; refinments <= max_refinments; ++refinments)
+        {
+            Solver solver(model.solver_params, false);
+            auto open_and_solve = [&](Timers &timers)
+            {
+                solver.timers.clear();
+                solver.clear();
+                solver.OpenMesh(mesh);
+                solver.static_refine_grid(refinments, model.integr.integration_radius, tips);
+                solver.setBoundaryConditions(model.boundary_conditions);
+                solver.run();
+                timers += solver.timers;
+            };
+            Timers first_run_timers;
+            open_and_solve(first_run_timers);
+            const json parameters = {
+                {"tips", tips.size()}, {"static_refinments", refinments},
+                {"cells", solver.NumberOfRefinedCells()}, {"dofs", solver.NumberOfDOFs()},
+                {"cg_iterations", solver.number_of_solver_iterations}};
+
+            benchmarks.push_back(Measure("solver", parameters, repeats, open_and_solve));
+
+            auto integration = Measure("integration", parameters, repeats, [&model, &solver](Timers &timers)
+            {
+                solver.timers.clear();
+                for (const auto &id: model.rivers.TipBranchesIds())
+                {
+                    const auto &branch = model.rivers.at(id);
+                    solver.integrate_new(model.integr, branch.TipPoint(), branch.TipAngle());
+                }
+                timers += solver.timers;
+            });
+            integration["median_per_tip"] = integration["median"].get<double>() / tips.size();
+            benchmarks.push_back(integration);
+        }
+
+        //JSON state of the biggest tree
+        {
+            auto model = TreeModel(max_depth);
+            const string file_name = "riversim_bench_model";
+            const json parameters = {{"tips", model.rivers.TipPoints().size()}, {"boundary_vertices", model.boundary.vertices.size()}};
+
+            benchmarks.push_back(Measure("json_save", parameters, repeats, [&model, &file_name](Timers &)
+            {
+                Save(model, file_name);
+            }));
+
+            benchmarks.push_back(Measure("json_open", parameters, repeats, [&file_name](Timers &)
+            {
+                Model opened_model;
+                Open(opened_model, file_name + ".json");
+            }));
+            remove((file_name + ".json").c_str());
+        }
+
+        json report = {
+            {"program", ProgramTitle()},
+            {"version", version_string()},
+            {"hardware_threads", thread::hardware_concurrency()},
+            {"benchmarks", benchmarks}};
+
+        const auto output_file_name = po["output"].as<string>();
+        if (output_file_name.empty())
+            cout << setw(4) << report << endl;
+        else
+        {
+            ofstream out(output_file_name);
+            if (!out)
+                throw Exception("riversim_bench: can't create output file " + output_file_name);
+            out << setw(4) << report << endl;
+        }
+    }
+    catch (const River::Exception &caught)
+    {
+        cout << "river exception" << endl;
+        cout << caught.what() << endl;
+        return 1;
+    }
+    catch (const dealii::ExceptionBase &caught)
+    {
+        cout << "dealii exception" << endl;
+        cout << caught.what() << endl;
+        return 1;
+    }
+    catch (const cxxopts::OptionException &caught)
+    {
+        cout << "option exception" << endl;
+        cout << caught.what() << endl;
+        return 2;
+    }
+
+    return 0;
+}
@@ -0,0 +1,89 @@
+//Link to Boost
+//#define BOOST_TEST_DYN_LINK
+
+//Define our Module name (prints at testing)
+#define BOOST_TEST_MODULE "DistributedSolver"
+
+//VERY IMPORTANT - include this last
+#include <boost/test/unit_test.hpp>
+
+#include "distributed_solver.hpp"
+#include "meshes.hpp"
+
+using namespace River;
+
+namespace utf = boost::unit_test;
+
+//MPI is initialized once for all tests, test is run by "mpirun -np 2 ./tdistributed_solver"
+struct MPIFixture
+{
+    MPIFixture():
+        mpi_initialization{utf::framework::master_test_suite().argc, utf::framework::master_test_suite().argv, 1}
+    {}
+
+    Utilities::MPI::MPI_InitFinalize mpi_initialization;
+};
+
+BOOST_GLOBAL_FIXTURE(MPIFixture);
+
+#ifdef RIVERSIM_DISTRIBUTED_SOLVER
+BOOST_AUTO_TEST_CASE( Same_As_Serial_Solver,
+    *utf::tolerance(1e-6))
+{
+    //each process has same coarse mesh, so serial solver on it is reference
+    const auto mesh = UnitSquareMesh(8);
+    BoundaryConditions boundary_conditions;
+    boundary_conditions[1] = BoundaryCondition(DIRICHLET, 0);
+    const t_PointList tips{{0.5, 0.5}, {0.25, 0.75}};
+    const vector<double> tips_angles{M_PI / 2, 0};
+    const unsigned n_refinments = 2;
+    const double refinment_radius = 0.05;
+
+    SolverParams params;
+    params.field_value = 1;
+
+    Solver serial(params, false);
+    serial.setBoundaryConditions(boundary_conditions);
+    serial.OpenMeshIfChanged(mesh, n_refinments, refinment_radius, tips);
+    serial.run();
+
+    DistributedSolver distributed(params);
+    distributed.OpenMesh(mesh);
+    distributed.static_refine_grid(n_refinments, refinment_radius, tips);
+    distributed.setBoundaryConditions(boundary_conditions);
+    distributed.run();
+
+    BOOST_TEST(NumberOfProcesses() == 2);
+    BOOST_TEST(distributed.NumberOfRefinedCells() == serial.NumberOfRefinedCells());
+    BOOST_TEST(distributed.NumberOfDOFs() == serial.NumberOfDOFs());
+
+    //points in cells of both processes, on common edges of cells and outside of region
+    const t_PointList points{{0.5, 0.5}, {0.51, 0.48}, {0.25, 0.75}, {0.1, 0.1}, {0.9, 0.3}, {0.625, 0.375}, {1.5, 0.5}};
+    vector<double> serial_values, distributed_values, mask;
+    vector<bool> inside;
+    serial.values(points, serial_values, inside);
+    distributed.values(points, distributed_values, mask);
+    for (size_t k = 0; k < points.size(); ++k)
+    {
+        BOOST_TEST(mask[k] == (inside[k] ? 1. : 0.));
+        BOOST_TEST(distributed_values[k] == serial_values[k]);
+    }
+
+    //stencil and spectral integration
+    for (const unsigned integration_method: {0, 1})
+    {
+        IntegrationParams integ;
+        integ.integration_method = integration_method;
+        const auto series_params = distributed.integrate_tips(integ, tips, tips_angles);
+        for (size_t i = 0; i < tips.size(); ++i)
+        {
+            const auto serial_series_params = integration_method == 1 ?
+                serial.integrate_spectral(integ, tips[i], tips_angles[i]) :
+                serial.integrate_new(integ, tips[i], tips_angles[i]);
+            BOOST_TEST(series_params[i].size() == serial_series_params.size());
+            for (size_t j = 0; j < serial_series_params.size(); ++j)
+                BOOST_TEST(series_params[i][j] == serial_series_params[j]);
+        }
+    }
+}
+#endif
@@ -0,0 +1,112 @@
+//Link to Boost
+//#define BOOST_TEST_DYN_LINK
+
+//Define our Module name (prints at testing)
+#define BOOST_TEST_MODULE "IO"
+
+//VERY IMPORTANT - include this last
+#include <boost/test/unit_test.hpp>
+
+#include <cstdio>
+#include <fstream>
+#include "io.hpp"
+
+namespace utf = boost::unit_test;
+using namespace River;
+
+///Parameters, geometry and collected data of \p opened model are the same as of \p saved one.
+void CheckSameState(const Model &opened, const Model &saved)
+{
+    BOOST_TEST((opened == saved));
+    BOOST_TEST((opened.rivers == saved.rivers));
+    BOOST_TEST((static_cast<const t_SeriesParameters&>(opened.series_parameters) == saved.series_parameters));
+    BOOST_TEST((opened.sim_data == saved.sim_data));
+    BOOST_TEST((opened.backward_data == saved.backward_data));
+}
+
+BOOST_AUTO_TEST_CASE( Journal_Round_Trip,
+    *utf::description("Model opened from journal at each step is the same as one recorded at this step"))
+{
+    const string file_name = "journal_round_trip.journal";
+    Model model;
+    model.InitializeLaplace();
+    Journal journal(3);
+    vector<Model> saved;
+    vector<json> records;
+
+    const unsigned n_steps = 10;
+    for (unsigned step = 0; step < n_steps; ++step)
+    {
+        if (step == 2)
+            model.rivers.GrowTestTree(model.river_boundary_id, 1, 0.01, 2, 0);
+        //tip of first subbranch is reverted, while other tips grow
+        else if (step == 5)
+            model.rivers.at(model.rivers.TipBranchesIds().front()).RemoveTipPoint();
+        else if (step == 7)
+        {
+            model.rivers.DeleteSubBranches(1);
+            model.backward_data[1].a1.push_back(0.5);
+        }
+
+        if (step > 0 && step != 5)
+            for (const auto id: model.rivers.TipBranchesIds())
+                model.rivers.at(id).AddPoint(Polar{0.01, 0.1 * step}, model.river_boundary_id);
+
+        for (const auto id: model.rivers.TipBranchesIds())
+            model.series_parameters.record({{id, {0.1 * step, 0.2, 0.3}}});
+        model.sim_data["Steps"].push_back(step);
+        if (step >= 4)
+            model.sim_data["New/Key"].push_back(step * step);
+
+        records.push_back(journal.Record(model));
+        saved.push_back(model);
+    }
+    {
+        ofstream out(file_name);
+        for (const auto &record: records)
+            out << record.dump() << '\n';
+    }
+
+    //full records are marked explicitly
+    for (unsigned step = 0; step < n_steps; ++step)
+        BOOST_TEST(records[step].value("full", false) == (step % 3 == 0));
+
+    for (unsigned step = 0; step < n_steps; ++step)
+    {
+        Model opened;
+        OpenJournal(opened, file_name, step);
+        CheckSameState(opened, saved[step]);
+    }
+    {
+        Model opened;
+        OpenJournal(opened, file_name);
+        CheckSameState(opened, saved.back());
+    }
+
+    //last record cut by interrupted run is ignored
+    {
+        Model next_model = model;
+        next_model.rivers.at(1).AddPoint(Polar{0.01, 0}, model.river_boundary_id);
+        auto record = journal.Record(next_model).dump();
+        ofstream out(file_name, ios::app);
+        out << record.substr(0, record.size() / 2);
+    }
+    {
+        Model opened;
+        OpenJournal(opened, file_name);
+        CheckSameState(opened, saved.back());
+        BOOST_CHECK_THROW(OpenJournal(opened, file_name, n_steps), River::Exception);
+    }
+
+    //invalid record before last one isn't ignored
+    {
+        ofstream out(file_name, ios::app);
+        out << '\n' << records.back().dump() << '\n';
+    }
+    {
+        Model opened;
+        BOOST_CHECK_THROW(OpenJournal(opened, file_name), River::Exception);
+    }
+
+    remove(file_name.c_str());
+}
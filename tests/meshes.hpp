@@ -0,0 +1,30 @@
+//Meshes shared by solver tests.
+#pragma once
+
+#include "tethex.hpp"
+
+//unit square split into n x n quadrangles, all boundary lines have id 1
+inline tethex::FlatMesh UnitSquareMesh(const unsigned n)
+{
+    tethex::FlatMesh mesh;
+    for (unsigned j = 0; j <= n; ++j)
+        for (unsigned i = 0; i <= n; ++i)
+            mesh.vertices.insert(mesh.vertices.end(), {i / double(n), j / double(n)});
+    for (unsigned j = 0; j < n; ++j)
+        for (unsigned i = 0; i < n; ++i)
+        {
+            auto v = (n + 1) * j + i;
+            mesh.quadrangles.insert(mesh.quadrangles.end(), {v, v + 1, v + n + 1, v + n + 2});
+            mesh.quadrangle_material_ids.push_back(0);
+        }
+    for (unsigned i = 0; i < n; ++i)
+    {
+        mesh.lines.insert(mesh.lines.end(), {i, i + 1});
+        mesh.lines.insert(mesh.lines.end(), {(n + 1) * n + i, (n + 1) * n + i + 1});
+        mesh.lines.insert(mesh.lines.end(), {(n + 1) * i, (n + 1) * (i + 1)});
+        mesh.lines.insert(mesh.lines.end(), {(n + 1) * i + n, (n + 1) * (i + 1) + n});
+    }
+    mesh.line_material_ids.assign(mesh.lines.size() / 2, 1);
+
+    return mesh;
+}
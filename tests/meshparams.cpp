@@ -0,0 +1,101 @@
+//Link to Boost
+//#define BOOST_TEST_DYN_LINK
+
+//Define our Module name (prints at testing)
+#define BOOST_TEST_MODULE "Mesh Params"
+
+//VERY IMPORTANT - include this last
+#include <boost/test/unit_test.hpp>
+
+#include <chrono>
+#include <random>
+#include "triangle.hpp"
+
+namespace utf = boost::unit_test;
+using namespace River;
+
+t_PointList RandomTips(const size_t n, const unsigned seed = 0)
+{
+    mt19937 gen(seed);
+    uniform_real_distribution<double> dist(0.01, 0.99);
+    t_PointList tips;
+    for (size_t i = 0; i < n; ++i)
+        tips.push_back({dist(gen), dist(gen)});
+    return tips;
+}
+
+BOOST_AUTO_TEST_CASE( Tips_Index_Nearest_Distance,
+    *utf::description("NearestTipDistance with index is the same as brute force search"))
+{
+    MeshParams mp;
+    mp.tip_points = RandomTips(300);
+    mp.BuildTipsIndex();
+    BOOST_TEST(mp.TipsIndexIsValid());
+
+    mt19937 gen(1);
+    uniform_real_distribution<double> dist(-0.5, 1.5);
+    for (int k = 0; k < 2000; ++k)
+    {
+        double x = dist(gen), y = dist(gen);
+        double best = numeric_limits<double>::infinity();
+        for (const auto &tip : mp.tip_points)
+            best = min(best, (Point{x, y} - tip).norm());
+
+        BOOST_TEST(mp.NearestTipDistance(x, y) == best);
+    }
+}
+
+BOOST_AUTO_TEST_CASE( Tips_Index_Area_Constraint,
+    *utf::description("meshAreaConstraint and refinementFunction with index are the same as brute force ones")
+    *utf::tolerance(1e-12))
+{
+    MeshParams mp, mp_indexed;
+    mp.tip_points = RandomTips(200, 2);
+    mp_indexed.tip_points = mp.tip_points;
+    mp_indexed.BuildTipsIndex();
+    BOOST_TEST(mp_indexed.TipsIndexIsValid());
+    BOOST_TEST(!mp.TipsIndexIsValid());
+
+    mt19937 gen(3);
+    uniform_real_distribution<double> dist(0, 1), delta(-0.01, 0.01);
+    for (int k = 0; k < 2000; ++k)
+    {
+        double x = dist(gen), y = dist(gen);
+        BOOST_TEST(mp_indexed.meshAreaConstraint(x, y) == mp.meshAreaConstraint(x, y));
+
+        Point p1{x, y}, p2{x + delta(gen), y + delta(gen)}, p3{x + delta(gen), y + delta(gen)};
+        auto area = abs((p2.x - p1.x)*(p3.y - p1.y) - (p3.x - p1.x)*(p2.y - p1.y)) / 2;
+        BOOST_TEST(mp_indexed.refinementFunction(p1, p2, p3, area) == mp.refinementFunction(p1, p2, p3, area));
+    }
+
+    //index isn't valid when tips are moved or number of tips changes
+    mp_indexed.tip_points.front().x += 1e-3;
+    BOOST_TEST(!mp_indexed.TipsIndexIsValid());
+    mp_indexed.BuildTipsIndex();
+    BOOST_TEST(mp_indexed.TipsIndexIsValid());
+    mp_indexed.tip_points.push_back({0.5, 0.5});
+    BOOST_TEST(!mp_indexed.TipsIndexIsValid());
+}
+
+BOOST_AUTO_TEST_CASE( Mesh_Generation_Time_vs_Tips_Number,
+    *utf::description("Benchmark: prints mesh generation time for different number of tips"))
+{
+    Boundary boundary{
+        {{0, 0}, {1, 0}, {1, 1}, {0, 1}},
+        {{0, 1, 0}, {1, 2, 1}, {2, 3, 2}, {3, 0, 3}}};
+
+    for (size_t n: {1, 10, 100, 400})
+    {
+        MeshParams mp;
+        mp.tip_points = RandomTips(n, 4);
+        Triangle triangle(mp);
+
+        auto start = chrono::steady_clock::now();
+        auto mesh = triangle.generate_quadrangular_mesh(boundary, {});
+        chrono::duration<double> elapsed = chrono::steady_clock::now() - start;
+
+        BOOST_TEST(mesh.get_n_quadrangles() > 0);
+        BOOST_TEST_MESSAGE("tips: " << n << ", quadrangles: " << mesh.get_n_quadrangles()
+            << ", generation time: " << elapsed.count() << " s");
+    }
+}
@@ -9,6 +9,7 @@
 
 #include <math.h>
 #include "solver.hpp"
+#include "meshes.hpp"
 
 using namespace River;
 
@@ -50,3 +51,268 @@ BOOST_AUTO_TEST_CASE( a1,
     BOOST_TEST((I/I_n) == 1.);
 }
 
+BOOST_AUTO_TEST_CASE( Nested_Spectral_Stencil, 
+    *utf::tolerance(1e-8))
+{
+    IntegrationParams integ;
+    const vector<double> exact_params{1.3, 0.7, 0.4};
+    //series parameters of field, which is exactly sum of base vectors
+    auto error = [&](const IntegrationStencil &stencil)
+    {
+        vector<double> values(stencil.size(), 0);
+        for (size_t k = 0; k < stencil.size(); ++k)
+            for (unsigned n = 0; n < exact_params.size(); ++n)
+                values[k] += exact_params[n] * integ.BaseVectorFinal(n + 1, 0, stencil.dx[k], stencil.dy[k]);
+
+        const auto series_params = stencil.SeriesParameters(values, vector<double>(stencil.size(), 1));
+        double max_error = 0;
+        for (unsigned n = 0; n < exact_params.size(); ++n)
+            max_error = max(max_error, abs(series_params[n] - exact_params[n]));
+        return max_error;
+    };
+
+    const IntegrationStencil uniform(integ), coarse(integ, 0), fine(integ, 1);
+
+    //samples of coarse level are first samples of next level
+    BOOST_TEST(fine.size() > coarse.size());
+    for (size_t k = 0; k < coarse.size(); ++k)
+    {
+        BOOST_TEST(fine.dx[k] == coarse.dx[k]);
+        BOOST_TEST(fine.dy[k] == coarse.dy[k]);
+    }
+
+    //only new samples are returned
+    const auto points = fine.Points({1, 2}, M_PI / 2, coarse.size());
+    BOOST_TEST(points.size() == fine.size() - coarse.size());
+    BOOST_TEST(points.front().x == 1 - fine.dy[coarse.size()]);
+    BOOST_TEST(points.front().y == 2 + fine.dx[coarse.size()]);
+
+    //same accuracy with hundreds times less samples then uniform grid of integrate_new
+    BOOST_TEST(coarse.size() * 100 < uniform.size());
+    BOOST_TEST(error(coarse) < error(uniform));
+    BOOST_TEST(error(fine) < 1e-8);
+}
+
+
+BOOST_AUTO_TEST_CASE( Reuse_Of_Unchanged_Mesh, 
+    *utf::tolerance(1e-8))
+{
+    const auto mesh = UnitSquareMesh(2);
+
+    BoundaryConditions boundary_conditions;
+    boundary_conditions[1] = BoundaryCondition(DIRICHLET, 0);
+    const t_PointList tips{{0.5, 0.5}};
+
+    Solver solver(SolverParams{}, false);
+    solver.setBoundaryConditions(boundary_conditions);
+    BOOST_TEST(!solver.OpenMeshIfChanged(mesh, 2, 0.1, tips));
+    solver.run();
+    BOOST_TEST(!solver.is_system_reused);
+    const auto value = solver.value({0.5, 0.5});
+    const auto n_dofs = solver.NumberOfDOFs();
+    BOOST_TEST(value > 0);
+
+    //same mesh: only right hand side is assembled
+    BOOST_TEST(solver.OpenMeshIfChanged(mesh, 2, 0.1, tips));
+    solver.run();
+    BOOST_TEST(solver.is_system_reused);
+    BOOST_TEST(solver.NumberOfDOFs() == n_dofs);
+    BOOST_TEST(solver.value({0.5, 0.5}) == value);
+
+    //boundary values are applied to kept stiffness matrix, solution is shifted by constant
+    boundary_conditions[1].value = 1;
+    solver.setBoundaryConditions(boundary_conditions);
+    BOOST_TEST(solver.OpenMeshIfChanged(mesh, 2, 0.1, tips));
+    solver.run();
+    BOOST_TEST(solver.value({0.5, 0.5}) == value + 1);
+
+    //tips define static refinment, so mesh is opened again
+    BOOST_TEST(!solver.OpenMeshIfChanged(mesh, 2, 0.1, {{0.25, 0.25}}));
+    solver.run();
+    BOOST_TEST(!solver.is_system_reused);
+}
+
+BOOST_AUTO_TEST_CASE( Spectral_Integration_Reuses_Samples)
+{
+    const auto mesh = UnitSquareMesh(4);
+
+    BoundaryConditions boundary_conditions;
+    boundary_conditions[1] = BoundaryCondition(DIRICHLET, 0);
+    const Point tip{0.5, 0.5};
+
+    SolverParams params;
+    params.field_value = 1;
+    Solver solver(params, false);
+    solver.setBoundaryConditions(boundary_conditions);
+    solver.OpenMeshIfChanged(mesh, 4, 0.1, {tip});
+    solver.run();
+
+    IntegrationParams integ;
+    integ.integration_method = 1;
+    size_t n_samples = 0;
+    const auto series_params = solver.integrate_spectral(integ, tip, 0, n_samples);
+    BOOST_TEST(series_params.size() == 3);
+
+    //each sample is evaluated once, so number of evaluations is size of last level
+    bool is_level_size = false;
+    for (unsigned level = 0; level <= integ.spectral_max_levels; ++level)
+        is_level_size = is_level_size || n_samples == IntegrationStencil(integ, level).size();
+    BOOST_TEST(is_level_size);
+    BOOST_TEST(n_samples < IntegrationStencil(integ).size());
+}
+
+BOOST_AUTO_TEST_CASE( Geometric_Multigrid, 
+    *utf::tolerance(1e-6))
+{
+    const auto mesh = UnitSquareMesh(4);
+
+    BoundaryConditions boundary_conditions;
+    boundary_conditions[1] = BoundaryCondition(DIRICHLET, 0);
+    const t_PointList tips{{0.5, 0.5}};
+
+    SolverParams multigrid_params;
+    multigrid_params.preconditioner_type = 3;
+
+    vector<unsigned> iterations;
+    for (unsigned refinments = 1; refinments <= 5; ++refinments)
+    {
+        Solver multigrid(multigrid_params, false);
+        multigrid.setBoundaryConditions(boundary_conditions);
+        multigrid.OpenMeshIfChanged(mesh, refinments, 0.2, tips);
+        multigrid.run();
+        iterations.push_back(multigrid.number_of_solver_iterations);
+
+        //same mesh(with same smoothing of refinment) is solved by SSOR preconditioner
+        Solver ssor(multigrid_params, false);
+        ssor.preconditioner_type = 0;
+        ssor.setBoundaryConditions(boundary_conditions);
+        ssor.OpenMeshIfChanged(mesh, refinments, 0.2, tips);
+        ssor.run();
+        BOOST_TEST(multigrid.value({0.5, 0.5}) == ssor.value({0.5, 0.5}));
+        BOOST_TEST(multigrid.value({0.3, 0.6}) == ssor.value({0.3, 0.6}));
+
+        //level matrices are kept for same mesh
+        BOOST_TEST(multigrid.OpenMeshIfChanged(mesh, refinments, 0.2, tips));
+        multigrid.run();
+        BOOST_TEST(multigrid.value({0.5, 0.5}) == ssor.value({0.5, 0.5}));
+    }
+
+    //number of iterations doesn't grow with levels
+    BOOST_TEST(iterations.back() <= iterations.front() + 3);
+}
+
+BOOST_AUTO_TEST_CASE( Far_Field_Condensation, 
+    *utf::tolerance(1e-6))
+{
+    const auto mesh = UnitSquareMesh(8);
+
+    BoundaryConditions boundary_conditions;
+    boundary_conditions[1] = BoundaryCondition(DIRICHLET, 0.5);
+
+    SolverParams params;
+    params.field_value = 1;
+    params.tollerance = 1e-12;
+    params.condensation_radius = 0.3;
+    Solver condensed(params, false);
+    condensed.setBoundaryConditions(boundary_conditions);
+
+    auto compare_with_whole_system = [&](const t_PointList &tips)
+    {
+        condensed.OpenMeshIfChanged(mesh, 2, 0.1, tips);
+        condensed.run();
+
+        Solver whole(params, false);
+        whole.condensation_radius = 0;
+        whole.setBoundaryConditions(boundary_conditions);
+        whole.OpenMeshIfChanged(mesh, 2, 0.1, tips);
+        whole.run();
+
+        for (const auto &p: t_PointList{tips.front(), {0.45, 0.55}, {0.1, 0.1}, {0.8, 0.3}, {0.95, 0.9}})
+            BOOST_TEST(condensed.value(p) == whole.value(p));
+    };
+
+    compare_with_whole_system({{0.5, 0.5}});
+    BOOST_TEST(condensed.timers.counters.at("FarFieldCondensations").total_value == 1);
+
+    //tip moves inside of zone, so far field is reused with new triangulation
+    compare_with_whole_system({{0.52, 0.5}});
+    BOOST_TEST(condensed.timers.counters.at("FarFieldCondensations").total_value == 1);
+
+    //tip approaches interface of zone, so far field is condensed again
+    compare_with_whole_system({{0.5, 0.74}});
+    BOOST_TEST(condensed.timers.counters.at("FarFieldCondensations").total_value == 2);
+}
+
+BOOST_AUTO_TEST_CASE( Mixed_Precision, 
+    *utf::tolerance(1e-8))
+{
+    const auto mesh = UnitSquareMesh(4);
+
+    BoundaryConditions boundary_conditions;
+    boundary_conditions[1] = BoundaryCondition(DIRICHLET, 0);
+    const t_PointList tips{{0.5, 0.5}};
+
+    SolverParams params;
+    params.field_value = 1;
+    for (unsigned preconditioner_type: {0, 1})
+    {
+        params.preconditioner_type = preconditioner_type;
+
+        params.mixed_precision = true;
+        Solver mixed(params, false);
+        mixed.setBoundaryConditions(boundary_conditions);
+        mixed.OpenMeshIfChanged(mesh, 4, 0.2, tips);
+        mixed.run();
+
+        params.mixed_precision = false;
+        Solver full(params, false);
+        full.setBoundaryConditions(boundary_conditions);
+        full.OpenMeshIfChanged(mesh, 4, 0.2, tips);
+        full.run();
+
+        //single precision corrections reach same tollerance
+        BOOST_TEST(mixed.timers.counters.at("MixedPrecisionCorrections").total_value >= 2);
+        BOOST_TEST(mixed.value({0.5, 0.5}) == full.value({0.5, 0.5}));
+        BOOST_TEST(mixed.value({0.3, 0.6}) == full.value({0.3, 0.6}));
+        BOOST_TEST(mixed.value({0.9, 0.1}) == full.value({0.9, 0.1}));
+    }
+}
+
+#ifdef DEAL_II_WITH_UMFPACK
+BOOST_AUTO_TEST_CASE( Direct_Solver, 
+    *utf::tolerance(1e-8))
+{
+    const auto mesh = UnitSquareMesh(4);
+
+    BoundaryConditions boundary_conditions;
+    boundary_conditions[1] = BoundaryCondition(DIRICHLET, 0);
+    const t_PointList tips{{0.5, 0.5}};
+
+    SolverParams params;
+    params.field_value = 1;
+    params.direct_solver = true;
+    Solver direct(params, false);
+    direct.setBoundaryConditions(boundary_conditions);
+    direct.OpenMeshIfChanged(mesh, 3, 0.2, tips);
+    direct.run();
+
+    params.direct_solver = false;
+    Solver cg(params, false);
+    cg.setBoundaryConditions(boundary_conditions);
+    cg.OpenMeshIfChanged(mesh, 3, 0.2, tips);
+    cg.run();
+
+    BOOST_TEST(direct.number_of_solver_iterations == 0);
+    BOOST_TEST(direct.value({0.5, 0.5}) == cg.value({0.5, 0.5}));
+    BOOST_TEST(direct.value({0.3, 0.6}) == cg.value({0.3, 0.6}));
+
+    //same mesh with other boundary values changes only right hand side, so factorization is reused
+    boundary_conditions[1] = BoundaryCondition(DIRICHLET, 1);
+    direct.setBoundaryConditions(boundary_conditions);
+    BOOST_TEST(direct.OpenMeshIfChanged(mesh, 3, 0.2, tips));
+    direct.run();
+    BOOST_TEST(direct.timers.counters.at("Factorizations").total_value == 1);
+    BOOST_TEST(direct.timers.counters.at("ReusedFactorizations").total_value == 1);
+    BOOST_TEST(direct.value({0.5, 0.5}) == cg.value({0.5, 0.5}) + 1);
+}
+#endif
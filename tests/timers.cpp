@@ -0,0 +1,68 @@
+//Link to Boost
+//#define BOOST_TEST_DYN_LINK
+
+//Define our Module name (prints at testing)
+#define BOOST_TEST_MODULE "Timers"
+
+//VERY IMPORTANT - include this last
+#include <boost/test/unit_test.hpp>
+
+#include <sstream>
+#include <thread>
+#include "timers.hpp"
+
+namespace utf = boost::unit_test;
+using namespace River;
+
+BOOST_AUTO_TEST_CASE( Step_And_Total_Values,
+    *utf::tolerance(1e-12))
+{
+    Timers timers;
+    timers.add("Solve", 1);
+    timers.add("Solve/Assembly", 0.25);
+    timers.add("Solve", 2);
+    timers.count("Solves");
+    timers.count("Solves", 2);
+
+    BOOST_TEST(timers.phases["Solve"].step_time == 3.);
+    BOOST_TEST(timers.phases["Solve"].step_calls == 2);
+    BOOST_TEST(timers.counters["Solves"].step_value == 3.);
+
+    timers.next_step();
+    timers.add("Solve", 0.5);
+    BOOST_TEST(timers.phases["Solve"].step_time == 0.5);
+    BOOST_TEST(timers.phases["Solve"].step_calls == 1);
+    BOOST_TEST(timers.phases["Solve"].total_time == 3.5);
+    BOOST_TEST(timers.phases["Solve"].total_calls == 3);
+    BOOST_TEST(timers.phases["Solve/Assembly"].step_time == 0.);
+    BOOST_TEST(timers.counters["Solves"].step_value == 0.);
+    BOOST_TEST(timers.counters["Solves"].total_value == 3.);
+
+    Timers other;
+    other.add("MeshGeneration", 1);
+    other.add("Solve", 1);
+    timers += other;
+    BOOST_TEST(timers.phases.size() == 3);
+    BOOST_TEST(timers.phases["Solve"].total_time == 4.5);
+
+    //subphases are printed by their short names and aren't part of total time
+    stringstream table;
+    table << timers;
+    BOOST_TEST(table.str().find("  Assembly") != string::npos);
+    BOOST_TEST(table.str().find("81.8%") != string::npos);
+
+    timers.clear();
+    BOOST_TEST(timers.phases.empty());
+    BOOST_TEST(timers.counters.empty());
+}
+
+BOOST_AUTO_TEST_CASE( Scope_Adds_Elapsed_Time )
+{
+    Timers timers;
+    {
+        auto timer = timers.scope("Sleep");
+        this_thread::sleep_for(chrono::milliseconds(20));
+    }
+    BOOST_TEST(timers.phases["Sleep"].total_calls == 1);
+    BOOST_TEST(timers.phases["Sleep"].total_time >= 0.02);
+}
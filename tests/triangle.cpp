@@ -0,0 +1,392 @@
+//Link to Boost
+//#define BOOST_TEST_DYN_LINK
+
+//Define our Module name (prints at testing)
+#define BOOST_TEST_MODULE "Triangle"
+
+//VERY IMPORTANT - include this last
+#include <boost/test/unit_test.hpp>
+
+#include <algorithm>
+#include <cstdio>
+#include <fstream>
+#include <map>
+#include <set>
+#include <tuple>
+#include "triangle.hpp"
+
+namespace utf = boost::unit_test;
+using namespace River;
+
+const double eps = 1e-12;
+
+///Cells as sorted lists of vertex coordinates, so meshes with different numeration can be compared.
+vector<vector<pair<double, double>>> Cells(const vector<vector<pair<double, double>>> &cells)
+{
+    auto result = cells;
+    for (auto &cell: result)
+        sort(cell.begin(), cell.end());
+    sort(result.begin(), result.end());
+    return result;
+}
+
+BOOST_AUTO_TEST_CASE( Flat_Mesh_vs_Tethex_Mesh,
+    *utf::description("Flat quadrangular mesh is the same as one converted by tethex"))
+{
+    //slit of nonzero width, so all vertices are distinct
+    Boundary boundary{
+        {{0, 0}, {1, 0}, {1, 1}, {0.505, 1}, {0.5, 0.7}, {0.495, 1}, {0, 1}},
+        {{0, 1, 1}, {1, 2, 2}, {2, 3, 3}, {3, 4, 4}, {4, 5, 4}, {5, 6, 3}, {6, 0, 2}}};
+
+    MeshParams mp;
+    mp.tip_points = {{0.5, 0.7}};
+    Triangle triangle(mp);
+
+    auto tethex_mesh = triangle.generate_quadrangular_mesh(boundary, {});
+    auto flat_mesh = triangle.generate_flat_quadrangular_mesh(boundary, {});
+
+    BOOST_TEST(flat_mesh.get_n_vertices() == tethex_mesh.get_n_vertices());
+    BOOST_TEST(flat_mesh.get_n_quadrangles() == tethex_mesh.get_n_quadrangles());
+    BOOST_TEST(flat_mesh.get_n_lines() == tethex_mesh.get_n_lines());
+
+    vector<vector<pair<double, double>>> tethex_cells, flat_cells;
+    for (size_t i = 0; i < tethex_mesh.get_n_quadrangles(); ++i)
+    {
+        vector<pair<double, double>> cell;
+        for (int k = 0; k < 4; ++k)
+        {
+            auto &p = tethex_mesh.get_vertex(tethex_mesh.get_quadrangle(i).get_vertex(k));
+            cell.push_back({p.get_coord(0), p.get_coord(1)});
+        }
+        tethex_cells.push_back(cell);
+    }
+    for (size_t i = 0; i < flat_mesh.get_n_quadrangles(); ++i)
+    {
+        vector<pair<double, double>> cell;
+        for (int k = 0; k < 4; ++k)
+        {
+            auto v = flat_mesh.quadrangles[4 * i + k];
+            cell.push_back({flat_mesh.vertices[2 * v], flat_mesh.vertices[2 * v + 1]});
+        }
+        flat_cells.push_back(cell);
+
+        //deal.II order: 0, 1, 3, 2 goes counterclockwise
+        const auto &c = cell;
+        double area =
+              (c[0].first * c[1].second - c[1].first * c[0].second)
+            + (c[1].first * c[3].second - c[3].first * c[1].second)
+            + (c[3].first * c[2].second - c[2].first * c[3].second)
+            + (c[2].first * c[0].second - c[0].first * c[2].second);
+        BOOST_TEST(area > 0);
+    }
+
+    auto a = Cells(tethex_cells), b = Cells(flat_cells);
+    BOOST_TEST(a.size() == b.size());
+    bool same = true;
+    for (size_t i = 0; i < a.size() && same; ++i)
+        for (size_t k = 0; k < 4; ++k)
+            same = same && abs(a[i][k].first - b[i][k].first) < eps && abs(a[i][k].second - b[i][k].second) < eps;
+    BOOST_TEST(same);
+
+    //boundary ids of lines
+    vector<int> tethex_ids, flat_ids = flat_mesh.line_material_ids;
+    for (size_t i = 0; i < tethex_mesh.get_n_lines(); ++i)
+        tethex_ids.push_back(tethex_mesh.get_line(i).get_material_id());
+    sort(tethex_ids.begin(), tethex_ids.end());
+    sort(flat_ids.begin(), flat_ids.end());
+    BOOST_TEST(tethex_ids == flat_ids);
+}
+
+///Reads raw value from binary stream.
+template<class T>
+T ReadRaw(istream &in)
+{
+    T value;
+    in.read(reinterpret_cast<char*>(&value), sizeof(T));
+    return value;
+}
+
+///Reads binary Gmsh 2.2 file written by tethex::FlatMesh::write, quadrangles are in deal.II order.
+tethex::FlatMesh ReadMsh22Binary(const string &file)
+{
+    ifstream in(file, ios::binary);
+    string section;
+    double version;
+    int file_type, data_size;
+    size_t n_vertices, n_elements;
+    in >> section >> version >> file_type >> data_size;
+    in.get();
+    BOOST_TEST(version == 2.2);
+    BOOST_TEST(file_type == 1);
+    BOOST_TEST(ReadRaw<int>(in) == 1);
+
+    tethex::FlatMesh mesh;
+    in >> section >> section >> n_vertices;
+    in.get();
+    for (size_t v = 0; v < n_vertices; ++v)
+    {
+        BOOST_TEST(ReadRaw<int>(in) == int(v + 1));
+        mesh.vertices.push_back(ReadRaw<double>(in));
+        mesh.vertices.push_back(ReadRaw<double>(in));
+        ReadRaw<double>(in);
+    }
+
+    in >> section >> section >> n_elements;
+    in.get();
+    for (size_t read = 0; read < n_elements;)
+    {
+        auto type = ReadRaw<int>(in), n = ReadRaw<int>(in), n_tags = ReadRaw<int>(in);
+        BOOST_TEST(n_tags == 2);
+        for (int el = 0; el < n; ++el, ++read)
+        {
+            ReadRaw<int>(in);
+            auto material_id = ReadRaw<int>(in);
+            ReadRaw<int>(in);
+            vector<unsigned> nodes(type == 1 ? 2 : 4);
+            for (auto &node: nodes)
+                node = ReadRaw<int>(in) - 1;
+            if (type == 1)
+            {
+                mesh.lines.insert(mesh.lines.end(), nodes.begin(), nodes.end());
+                mesh.line_material_ids.push_back(material_id);
+            }
+            else
+            {
+                mesh.quadrangles.insert(mesh.quadrangles.end(), {nodes[0], nodes[1], nodes[3], nodes[2]});
+                mesh.quadrangle_material_ids.push_back(material_id);
+            }
+        }
+    }
+    in >> section;
+    BOOST_TEST(section == "$EndElements");
+    return mesh;
+}
+
+///Reads binary Gmsh 4.1 file written by tethex::FlatMesh::write, material ids are physical tags of entities.
+tethex::FlatMesh ReadMsh41Binary(const string &file)
+{
+    ifstream in(file, ios::binary);
+    string section;
+    double version;
+    int file_type, data_size;
+    in >> section >> version >> file_type >> data_size;
+    in.get();
+    BOOST_TEST(version == 4.1);
+    BOOST_TEST(file_type == 1);
+    BOOST_TEST(ReadRaw<int>(in) == 1);
+
+    in >> section >> section;
+    in.get();
+    map<pair<int, int>, int> physical_tags;
+    auto n_points = ReadRaw<size_t>(in), n_curves = ReadRaw<size_t>(in), 
+        n_surfaces = ReadRaw<size_t>(in), n_volumes = ReadRaw<size_t>(in);
+    BOOST_TEST(n_points + n_volumes == 0u);
+    for (size_t entity = 0; entity < n_curves + n_surfaces; ++entity)
+    {
+        auto tag = ReadRaw<int>(in);
+        for (int k = 0; k < 6; ++k)
+            ReadRaw<double>(in);
+        BOOST_TEST(ReadRaw<size_t>(in) == 1u);
+        physical_tags[{entity < n_curves ? 1 : 2, tag}] = ReadRaw<int>(in);
+        BOOST_TEST(ReadRaw<size_t>(in) == 0u);
+    }
+
+    tethex::FlatMesh mesh;
+    in >> section >> section;
+    in.get();
+    auto n_blocks = ReadRaw<size_t>(in);
+    ReadRaw<size_t>(in);
+    ReadRaw<size_t>(in);
+    ReadRaw<size_t>(in);
+    for (size_t block = 0; block < n_blocks; ++block)
+    {
+        ReadRaw<int>(in);
+        ReadRaw<int>(in);
+        ReadRaw<int>(in);
+        auto n = ReadRaw<size_t>(in);
+        for (size_t v = 0; v < n; ++v)
+            BOOST_TEST(ReadRaw<size_t>(in) == v + 1);
+        for (size_t v = 0; v < n; ++v)
+        {
+            mesh.vertices.push_back(ReadRaw<double>(in));
+            mesh.vertices.push_back(ReadRaw<double>(in));
+            ReadRaw<double>(in);
+        }
+    }
+
+    in >> section >> section;
+    in.get();
+    n_blocks = ReadRaw<size_t>(in);
+    ReadRaw<size_t>(in);
+    ReadRaw<size_t>(in);
+    ReadRaw<size_t>(in);
+    for (size_t block = 0; block < n_blocks; ++block)
+    {
+        auto dim = ReadRaw<int>(in), tag = ReadRaw<int>(in), type = ReadRaw<int>(in);
+        auto material_id = physical_tags.at({dim, tag});
+        auto n = ReadRaw<size_t>(in);
+        for (size_t el = 0; el < n; ++el)
+        {
+            ReadRaw<size_t>(in);
+            vector<unsigned> nodes(type == 1 ? 2 : 4);
+            for (auto &node: nodes)
+                node = ReadRaw<size_t>(in) - 1;
+            if (type == 1)
+            {
+                mesh.lines.insert(mesh.lines.end(), nodes.begin(), nodes.end());
+                mesh.line_material_ids.push_back(material_id);
+            }
+            else
+            {
+                mesh.quadrangles.insert(mesh.quadrangles.end(), {nodes[0], nodes[1], nodes[3], nodes[2]});
+                mesh.quadrangle_material_ids.push_back(material_id);
+            }
+        }
+    }
+    in >> section;
+    BOOST_TEST(section == "$EndElements");
+    return mesh;
+}
+
+///Lines with their material ids, sorted, so meshes with different order of lines can be compared.
+vector<tuple<int, unsigned, unsigned>> Lines(const tethex::FlatMesh &mesh)
+{
+    vector<tuple<int, unsigned, unsigned>> lines;
+    for (size_t i = 0; i < mesh.get_n_lines(); ++i)
+        lines.push_back({mesh.line_material_ids[i], mesh.lines[2 * i], mesh.lines[2 * i + 1]});
+    sort(lines.begin(), lines.end());
+    return lines;
+}
+
+BOOST_AUTO_TEST_CASE( Flat_Mesh_Binary_Output,
+    *utf::description("Binary Gmsh 2.2 and 4.1 files have the same vertices, quadrangles and boundary ids as mesh"))
+{
+    //slit of nonzero width, so all vertices are distinct
+    Boundary boundary{
+        {{0, 0}, {1, 0}, {1, 1}, {0.505, 1}, {0.5, 0.7}, {0.495, 1}, {0, 1}},
+        {{0, 1, 1}, {1, 2, 2}, {2, 3, 3}, {3, 4, 4}, {4, 5, 4}, {5, 6, 3}, {6, 0, 2}}};
+    MeshParams mp;
+    mp.tip_points = {{0.5, 0.7}};
+    Triangle triangle(mp);
+    auto mesh = triangle.generate_flat_quadrangular_mesh(boundary, {});
+
+    //inner line, like ones of Triangle segments without marker
+    mesh.lines.insert(mesh.lines.end(), {mesh.quadrangles[0], mesh.quadrangles[1]});
+    mesh.line_material_ids.push_back(-1);
+    auto boundary_mesh = mesh;
+    boundary_mesh.lines.resize(boundary_mesh.lines.size() - 2);
+    boundary_mesh.line_material_ids.pop_back();
+
+    for (auto [format, file, expected]: {
+        make_tuple(tethex::MSH_22_BINARY, "binary_mesh_22.msh", &mesh), 
+        make_tuple(tethex::MSH_41_BINARY, "binary_mesh_41.msh", &boundary_mesh)})
+    {
+        mesh.write(file, format);
+        auto read = format == tethex::MSH_22_BINARY ? ReadMsh22Binary(file) : ReadMsh41Binary(file);
+        remove(file);
+
+        BOOST_TEST(read.get_n_vertices() == mesh.get_n_vertices());
+        BOOST_TEST(read.vertices == mesh.vertices);
+        BOOST_TEST(read.get_n_quadrangles() == mesh.get_n_quadrangles());
+        BOOST_TEST(read.quadrangles == mesh.quadrangles);
+        BOOST_TEST(read.quadrangle_material_ids == mesh.quadrangle_material_ids);
+        BOOST_TEST(read.get_n_lines() == expected->get_n_lines());
+        BOOST_TEST((Lines(read) == Lines(*expected)));
+    }
+}
+
+///Boundary of unit square with river of width \p w going from bottom side along \p river points.
+Boundary RiverBoundary(const t_PointList &river, const double w)
+{
+    Boundary boundary;
+    auto &vertices = boundary.vertices;
+    vertices.push_back({0, 0});
+    t_PointList left, right;
+    for (size_t i = 0; i + 1 < river.size(); ++i)
+    {
+        Point dir = i == 0 ? Point{0, 1} : river[i] - river[i - 1];
+        dir.normalize();
+        Point normal{-dir.y, dir.x};
+        left.push_back(river[i] + normal * (w / 2));
+        right.push_back(river[i] - normal * (w / 2));
+    }
+    vertices.insert(vertices.end(), left.begin(), left.end());
+    vertices.push_back(river.back());
+    vertices.insert(vertices.end(), right.rbegin(), right.rend());
+    const size_t river_end = vertices.size();
+    vertices.insert(vertices.end(), {{1, 0}, {1, 1}, {0, 1}});
+    for (size_t i = 0; i < vertices.size(); ++i)
+    {
+        long id = (i == 0 || i + 1 == river_end) ? 1 : (i < river_end ? 5 : i - river_end + 2);
+        boundary.lines.push_back(Line(i, (i + 1) % vertices.size(), id));
+    }
+    return boundary;
+}
+
+///Area of quadrangles and number of edges shared by more then two of them.
+pair<double, int> AreaAndNonConformingEdges(const tethex::FlatMesh &mesh)
+{
+    double area = 0;
+    map<pair<unsigned, unsigned>, int> edges;
+    for (size_t i = 0; i < mesh.get_n_quadrangles(); ++i)
+    {
+        //deal.II order: 0, 1, 3, 2 goes counterclockwise
+        unsigned q[4] = {mesh.quadrangles[4 * i], mesh.quadrangles[4 * i + 1], mesh.quadrangles[4 * i + 3], mesh.quadrangles[4 * i + 2]};
+        double cell_area = 0;
+        for (int k = 0; k < 4; ++k)
+        {
+            auto a = q[k], b = q[(k + 1) % 4];
+            cell_area += (mesh.vertices[2 * a] * mesh.vertices[2 * b + 1] - mesh.vertices[2 * b] * mesh.vertices[2 * a + 1]) / 2;
+            edges[{min(a, b), max(a, b)}]++;
+        }
+        BOOST_TEST(cell_area > 0);
+        area += cell_area;
+    }
+    int n_non_conforming = 0;
+    for (const auto &[edge, count]: edges)
+        n_non_conforming += count > 2;
+    return {area, n_non_conforming};
+}
+
+BOOST_AUTO_TEST_CASE( Incremental_Mesh_Update,
+    *utf::description("Mesh updated only around growing tip covers the same region as full one")
+    *utf::tolerance(1e-10))
+{
+    MeshParams mp;
+    mp.max_area = 1e-3;
+    mp.min_area = 1e-7;
+    mp.refinment_radius = 0.01;
+    mp.remeshing_radius = 0.03;
+    mp.full_remeshing_period = 5;
+    Triangle incremental(mp), full(mp);
+
+    t_PointList river{{0.5, 0}};
+    for (int k = 1; k <= 20; ++k)
+        river.push_back({0.5 + 0.02 * sin(k * 0.3), 0.01 * k});
+
+    int n_incremental = 0;
+    for (int step = 0; step < 12; ++step)
+    {
+        auto boundary = RiverBoundary(river, 1e-3);
+        incremental.mesh_params.tip_points = full.mesh_params.tip_points = {river.back()};
+        auto updated_mesh = incremental.update_flat_quadrangular_mesh(boundary, {});
+        auto full_mesh = full.generate_flat_quadrangular_mesh(boundary, {});
+        n_incremental += incremental.last_update_is_incremental();
+
+        auto [updated_area, updated_non_conforming] = AreaAndNonConformingEdges(updated_mesh);
+        auto [full_area, full_non_conforming] = AreaAndNonConformingEdges(full_mesh);
+        BOOST_TEST(updated_area == full_area);
+        BOOST_TEST(updated_non_conforming == 0);
+
+        //boundary lines can be split differently, but boundary ids are the same
+        set<int> updated_ids(updated_mesh.line_material_ids.begin(), updated_mesh.line_material_ids.end()),
+            full_ids(full_mesh.line_material_ids.begin(), full_mesh.line_material_ids.end());
+        BOOST_TEST(updated_ids == full_ids);
+
+        auto dir = river.back() - river[river.size() - 2];
+        dir.normalize();
+        river.push_back(river.back() + dir.rotate(0.15 * sin(step * 0.7)) * 0.01);
+    }
+    BOOST_TEST(n_incremental > 0);
+    BOOST_TEST(n_incremental < 12);
+}
@@ -0,0 +1,87 @@
+//Link to Boost
+//#define BOOST_TEST_DYN_LINK
+
+//Define our Module name (prints at testing)
+#define BOOST_TEST_MODULE "AsyncWriter"
+
+//VERY IMPORTANT - include this last
+#include <boost/test/unit_test.hpp>
+
+#include <atomic>
+#include <chrono>
+#include <vector>
+#include <stdexcept>
+#include "writer.hpp"
+
+using namespace River;
+
+BOOST_AUTO_TEST_CASE( Jobs_Order )
+{
+    vector<int> written;
+    {
+        AsyncWriter writer(2);
+        for (int i = 0; i < 20; ++i)
+            writer.push([&written, i]{ written.push_back(i); });
+        writer.wait();
+        BOOST_TEST(writer.size() == 0);
+        BOOST_TEST(written.size() == 20);
+
+        for (int i = 20; i < 30; ++i)
+            writer.push([&written, i]{ written.push_back(i); });
+    }
+    //destructor writes rest of queue
+    BOOST_TEST(written.size() == 30);
+    for (int i = 0; i < 30; ++i)
+        BOOST_TEST(written[i] == i);
+}
+
+BOOST_AUTO_TEST_CASE( Bounded_Queue )
+{
+    atomic<bool> is_released{false};
+    AsyncWriter writer(1);
+
+    writer.push([&is_released]{ while (!is_released) this_thread::sleep_for(chrono::milliseconds(1)); });
+    writer.push([]{});
+    //first job is running and second is queued, so next push has to wait for them
+    BOOST_TEST(writer.size() == 2);
+
+    atomic<bool> is_pushed{false};
+    thread pusher([&writer, &is_pushed]{ writer.push([]{}); is_pushed = true; });
+    this_thread::sleep_for(chrono::milliseconds(50));
+    BOOST_TEST(!is_pushed);
+
+    is_released = true;
+    pusher.join();
+    BOOST_TEST(is_pushed);
+    writer.wait();
+    BOOST_TEST(writer.size() == 0);
+}
+
+BOOST_AUTO_TEST_CASE( Synchronous_Mode )
+{
+    AsyncWriter writer(0);
+    auto caller_id = this_thread::get_id();
+    thread::id job_id;
+    writer.push([&job_id]{ job_id = this_thread::get_id(); });
+    BOOST_TEST((job_id == caller_id));
+    BOOST_CHECK_THROW(writer.push([]{ throw runtime_error("can't write"); }), runtime_error);
+}
+
+BOOST_AUTO_TEST_CASE( Job_Errors )
+{
+    AsyncWriter writer;
+    atomic<bool> is_released{false};
+    bool is_next_job_run = false;
+    writer.push([&is_released]
+    {
+        while (!is_released) this_thread::sleep_for(chrono::milliseconds(1));
+        throw runtime_error("can't write");
+    });
+    writer.push([&is_next_job_run]{ is_next_job_run = true; });
+    is_released = true;
+    BOOST_CHECK_THROW(writer.wait(), runtime_error);
+    BOOST_TEST(is_next_job_run);
+
+    //error is reported once
+    BOOST_CHECK_NO_THROW(writer.wait());
+}